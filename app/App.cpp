@@ -67,7 +67,8 @@ namespace ctb::app
       wxConfigBase::Set(cfg.release());
 
       // initialize label cache. needs to happen _after_ config store is set up
-      m_label_cache = std::make_shared<LabelImageCache>(getLabelCacheFolder());
+      m_task_executor = std::make_shared<tasks::TaskExecutor>();
+      m_label_cache = std::make_shared<LabelImageCache>(getLabelCacheFolder(), m_task_executor, getLabelCacheMaxBytes());
 
    } // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks) unfortunately no way around it with wxWidgets
 
@@ -97,6 +98,14 @@ namespace ctb::app
    int App::OnExit()
    {
       log::warn("App shutting down.");
+
+      // cancel and join any background tasks while logging is still available to them.
+      if (m_label_cache)
+         m_label_cache->shutdown();
+
+      if (m_task_executor)
+         m_task_executor->shutdown();
+
       log::flush();
       log::shutdown();
       
@@ -128,9 +137,23 @@ namespace ctb::app
       return getDataFolder(AppFolder::Labels);
    }
    
+   auto App::getLabelCacheMaxBytes() noexcept -> uint64_t
+   {
+      auto max_mb = constants::LABEL_CACHE_MAX_MB_DEFAULT;
+      try 
+      {
+         auto cfg = getConfig(constants::CONFIG_PATH_PREFERENCES);
+         max_mb = cfg->ReadLong(constants::CONFIG_VALUE_LABEL_CACHE_MAX_MB, constants::LABEL_CACHE_MAX_MB_DEFAULT);
+      }
+      catch (...) {
+         log::warn("Couldn't retrieve label cache size from config. {}", packageError().formattedMesage());
+      }
+      return static_cast<uint64_t>(std::max(max_mb, 1L)) * constants::ONE_MB;
+   }
+
    void App::setLabelCacheFolder(const fs::path& cache_folder)
    {
-      auto new_cache = std::make_shared<LabelImageCache>(cache_folder);
+      auto new_cache = std::make_shared<LabelImageCache>(cache_folder, m_task_executor, getLabelCacheMaxBytes());
       m_label_cache = new_cache;
    }
 
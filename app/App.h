@@ -11,6 +11,7 @@
 #include "wx_helpers.h"
 
 #include <ctb/log.h>
+#include <ctb/tasks/TaskExecutor.h>
 #include <wx/app.h>
 
 
@@ -109,11 +110,21 @@ namespace ctb::app
       auto getLabelCacheFolder() noexcept -> fs::path;
       void setLabelCacheFolder(const fs::path& cache_folder);
 
+      /// @brief getLabelCacheMaxBytes()
+      /// @return the size budget for the label cache folder
+      auto getLabelCacheMaxBytes() noexcept -> uint64_t;
+
       auto getLabelCache() noexcept -> LabelCachePtr
       {
          return m_label_cache;
       }
 
+      /// @brief get the thread pool used for running background tasks
+      auto getTaskExecutor() noexcept -> tasks::TaskExecutorPtr
+      {
+         return m_task_executor;
+      }
+
       /// @brief Get the current config object.
       ///
       /// Calling this will throw an exception if there's no default config. AFAIK the wxWidgets config store is 
@@ -137,9 +148,10 @@ namespace ctb::app
       }
 
    private:
-      MainFrame*         m_main_frame{};
-      fs::path           m_user_data_folder{};
-      LabelCachePtr      m_label_cache{};
+      MainFrame*              m_main_frame{};
+      fs::path                m_user_data_folder{};
+      tasks::TaskExecutorPtr  m_task_executor{};
+      LabelCachePtr           m_label_cache{};
    };
 
 }  // namespace ctb::app
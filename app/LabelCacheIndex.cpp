@@ -0,0 +1,282 @@
+/*********************************************************************
+ * @file       LabelCacheIndex.cpp
+ *
+ * @brief      implementation for the LabelCacheIndex class
+ *
+ * @copyright  Copyright © 2025 Jeff Kohn. All rights reserved.
+ *********************************************************************/
+
+#include "LabelCacheIndex.h"
+
+#include <ctb/utility.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+
+namespace ctb::app
+{
+
+   LabelCacheIndex::LabelCacheIndex(fs::path folder, uint64_t max_bytes) : 
+      m_folder{ std::move(folder) },
+      m_max_bytes{ max_bytes }
+   {
+      if (!load())
+      {
+         rebuild();
+      }
+
+      // budget may have been reduced since we last ran
+      std::scoped_lock lock{ m_mutex };
+      evict(0);
+   }
+
+
+   LabelCacheIndex::~LabelCacheIndex() noexcept
+   {
+      save();
+   }
+
+
+   auto LabelCacheIndex::path(uint64_t wine_id, FileType type) const -> fs::path
+   {
+      constexpr auto image_num = 1;
+      if (type == FileType::Thumbnail)
+         return m_folder / ctb::format(constants::FMT_LABEL_THUMBNAIL_FILENAME, wine_id, image_num);
+
+      return m_folder / ctb::format(constants::FMT_LABEL_IMAGE_FILENAME, wine_id, image_num);
+   }
+
+
+   auto LabelCacheIndex::contains(uint64_t wine_id, FileType type) const -> bool
+   {
+      std::scoped_lock lock{ m_mutex };
+
+      auto it = m_entries.find(wine_id);
+      if (it == m_entries.end())
+         return false;
+
+      return (type == FileType::Thumbnail ? it->second.thumb_bytes : it->second.label_bytes) > 0;
+   }
+
+
+   void LabelCacheIndex::touch(uint64_t wine_id)
+   {
+      std::scoped_lock lock{ m_mutex };
+      if (auto it = m_entries.find(wine_id); it != m_entries.end())
+      {
+         it->second.last_access = now();
+         markChanged();
+      }
+   }
+
+
+   void LabelCacheIndex::add(uint64_t wine_id, FileType type, uint64_t size)
+   {
+      std::scoped_lock lock{ m_mutex };
+
+      auto& entry = m_entries[wine_id];
+      auto& bytes = type == FileType::Thumbnail ? entry.thumb_bytes : entry.label_bytes;
+      m_total_bytes = m_total_bytes - bytes + size;
+      bytes = size;
+      entry.last_access = now();
+
+      evict(wine_id);
+      markChanged();
+   }
+
+
+   void LabelCacheIndex::remove(uint64_t wine_id, FileType type)
+   {
+      std::scoped_lock lock{ m_mutex };
+
+      auto it = m_entries.find(wine_id);
+      if (it == m_entries.end())
+         return;
+
+      auto& bytes = type == FileType::Thumbnail ? it->second.thumb_bytes : it->second.label_bytes;
+      m_total_bytes -= bytes;
+      bytes = 0;
+      if (it->second.label_bytes == 0 and it->second.thumb_bytes == 0)
+         m_entries.erase(it);
+
+      markChanged();
+   }
+
+
+   auto LabelCacheIndex::totalBytes() const -> uint64_t
+   {
+      std::scoped_lock lock{ m_mutex };
+      return m_total_bytes;
+   }
+
+
+   void LabelCacheIndex::save() noexcept
+   {
+      std::scoped_lock lock{ m_mutex };
+      if (m_unsaved_changes)
+         saveLocked();
+   }
+
+
+   auto LabelCacheIndex::load() -> bool
+   {
+      try
+      {
+         std::ifstream file{ m_folder / constants::LABEL_INDEX_FILENAME };
+         if (!file)
+            return false;
+
+         std::string line{};
+         if (!std::getline(file, line) or line != constants::LABEL_INDEX_HEADER)
+            return false;
+
+         while (std::getline(file, line))
+         {
+            std::istringstream fields{ line };
+            uint64_t wine_id{};
+            Entry entry{};
+            if (!(fields >> wine_id >> entry.label_bytes >> entry.thumb_bytes >> entry.last_access))
+               return false;
+
+            m_entries[wine_id] = entry;
+            m_total_bytes += entry.label_bytes + entry.thumb_bytes;
+         }
+         return true;
+      }
+      catch (...) {
+         log::warn("Couldn't load label cache index, it will be rebuilt. {}", packageError().formattedMesage());
+      }
+      return false;
+   }
+
+
+   void LabelCacheIndex::rebuild()
+   {
+      m_entries.clear();
+      m_total_bytes = 0;
+
+      // one pass over the folder, picking out files that match our naming scheme
+      std::error_code ec{};
+      for (const auto& dir_entry : fs::directory_iterator{ m_folder, ec })
+      {
+         if (!dir_entry.is_regular_file(ec))
+            continue;
+
+         auto filename = dir_entry.path().filename().string();
+         uint64_t wine_id{};
+         auto [ptr, err] = std::from_chars(filename.data(), filename.data() + filename.size(), wine_id);
+         if (err != std::errc{})
+            continue;
+
+         auto size = dir_entry.file_size(ec);
+         if (ec)
+            continue;
+
+         for (auto type : { FileType::Label, FileType::Thumbnail })
+         {
+            if (path(wine_id, type).filename() == dir_entry.path().filename())
+            {
+               auto& entry = m_entries[wine_id];
+               (type == FileType::Thumbnail ? entry.thumb_bytes : entry.label_bytes) = size;
+               m_total_bytes += size;
+            }
+         }
+      }
+
+      // we don't know the real access times, so everything starts out equal
+      auto timestamp = now();
+      for (auto& entry : m_entries | vws::values)
+      {
+         entry.last_access = timestamp;
+      }
+
+      // only called from the ctor, so no need to lock
+      log::info("Rebuilt label cache index, found {} labels using {} bytes.", m_entries.size(), m_total_bytes);
+      saveLocked();
+   }
+
+
+   void LabelCacheIndex::evict(uint64_t keep_wine_id)
+   {
+      if (m_total_bytes <= m_max_bytes)
+         return;
+
+      // oldest first
+      std::vector<std::pair<int64_t, uint64_t>> by_age{};
+      by_age.reserve(m_entries.size());
+      for (const auto& [wine_id, entry] : m_entries)
+      {
+         if (wine_id != keep_wine_id)
+            by_age.emplace_back(entry.last_access, wine_id);
+      }
+      rng::sort(by_age);
+
+      size_t evicted{};
+      for (const auto& wine_id : by_age | vws::values)
+      {
+         if (m_total_bytes <= m_max_bytes)
+            break;
+
+         auto it = m_entries.find(wine_id);
+         std::error_code ec{};
+         for (auto type : { FileType::Label, FileType::Thumbnail })
+         {
+            fs::remove(path(wine_id, type), ec);
+         }
+         m_total_bytes -= it->second.label_bytes + it->second.thumb_bytes;
+         m_entries.erase(it);
+         ++evicted;
+      }
+
+      if (evicted)
+      {
+         log::info("Evicted {} labels from the label cache.", evicted);
+         markChanged();
+      }
+   }
+
+
+   void LabelCacheIndex::markChanged()
+   {
+      if (++m_unsaved_changes >= constants::LABEL_INDEX_SAVE_INTERVAL)
+         saveLocked();
+   }
+
+
+   void LabelCacheIndex::saveLocked() noexcept
+   {
+      try
+      {
+         std::string text{ constants::LABEL_INDEX_HEADER };
+         text.append("\n");
+         for (const auto& [wine_id, entry] : m_entries)
+         {
+            text.append(ctb::format("{} {} {} {}\n", wine_id, entry.label_bytes, entry.thumb_bytes, entry.last_access));
+         }
+
+         // write to a temp file and rename, so a crash while saving doesn't corrupt the index.
+         auto index_path = m_folder / constants::LABEL_INDEX_FILENAME;
+         auto temp_path = index_path;
+         temp_path.replace_extension(constants::DOWNLOAD_FILE_EXTENSION);
+         saveTextToFile(temp_path, text, true);
+         fs::rename(temp_path, index_path);
+         m_unsaved_changes = 0;
+      }
+      catch (...) {
+         log::warn("Couldn't save label cache index. {}", packageError().formattedMesage());
+      }
+   }
+
+
+   auto LabelCacheIndex::now() -> int64_t
+   {
+      using namespace std::chrono;
+      return duration_cast<seconds>(system_clock::now().time_since_epoch()).count();
+   }
+
+} // namespace ctb::app
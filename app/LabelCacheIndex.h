@@ -0,0 +1,100 @@
+/*********************************************************************
+ * @file       LabelCacheIndex.h
+ *
+ * @brief      declaration for the LabelCacheIndex class 
+ *
+ * @copyright  Copyright © 2025 Jeff Kohn. All rights reserved.
+ *********************************************************************/
+#pragma once
+
+#include "App.h"
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+
+namespace ctb::app
+{
+
+   /// @brief index of the files in the label cache folder, with a size budget enforced by LRU eviction.
+   ///
+   /// The index is loaded from a file in the cache folder at startup (or rebuilt by scanning the folder 
+   /// if that file is missing), so checking whether a label is cached doesn't need to touch the disk. 
+   /// Changes are saved periodically and on shutdown, rather than after every change.
+   /// 
+   /// This class is thread-safe.
+   ///
+   class LabelCacheIndex final
+   {
+   public:
+      /// @brief types of file we keep for each label
+      enum class FileType
+      {
+         Label,
+         Thumbnail
+      };
+
+      /// @brief construct the index, loading it from disk or rebuilding it if necessary.
+      /// @param folder - the label cache folder, must already exist
+      /// @param max_bytes - size budget for the files in the cache
+      LabelCacheIndex(fs::path folder, uint64_t max_bytes);
+
+      /// @brief saves the index if it's been modified
+      ~LabelCacheIndex() noexcept;
+
+      /// @brief returns the path for the specified file, whether it exists or not
+      auto path(uint64_t wine_id, FileType type) const -> fs::path;
+
+      /// @brief check whether a file is in the cache. Doesn't update its last-access time.
+      auto contains(uint64_t wine_id, FileType type) const -> bool;
+
+      /// @brief update a label's last-access time
+      void touch(uint64_t wine_id);
+
+      /// @brief record a file that was added to the cache, evicting older labels if we're over budget.
+      void add(uint64_t wine_id, FileType type, uint64_t size);
+
+      /// @brief remove a file from the index, e.g. because it's missing or corrupt. Doesn't delete the file.
+      void remove(uint64_t wine_id, FileType type);
+
+      /// @brief total size of the files in the cache
+      auto totalBytes() const -> uint64_t;
+
+      /// @brief write the index to disk if it's been modified since the last save.
+      void save() noexcept;
+
+      LabelCacheIndex() = delete;
+      LabelCacheIndex(const LabelCacheIndex&) = delete;
+      LabelCacheIndex(LabelCacheIndex&&) = delete;
+      LabelCacheIndex& operator=(const LabelCacheIndex&) = delete;
+      LabelCacheIndex& operator=(LabelCacheIndex&&) = delete;
+
+   private:
+      struct Entry
+      {
+         uint64_t label_bytes{};
+         uint64_t thumb_bytes{};
+         int64_t  last_access{};
+      };
+      using Entries = std::unordered_map<uint64_t, Entry>;
+
+      const fs::path     m_folder;
+      const uint64_t     m_max_bytes;
+      mutable std::mutex m_mutex{};
+      Entries            m_entries{};
+      uint64_t           m_total_bytes{};
+      size_t             m_unsaved_changes{};
+
+      auto load() -> bool;
+      void rebuild();
+      void evict(uint64_t keep_wine_id);
+      void markChanged();
+      void saveLocked() noexcept;
+
+      static auto now() -> int64_t;
+   };
+
+   using LabelCacheIndexPtr = std::shared_ptr<LabelCacheIndex>;
+
+} // namespace ctb::app
@@ -13,30 +13,44 @@
 #include <wx/mstream.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <fstream>
 
 
 namespace ctb::app
 {
    using namespace ctb::tasks;
-   using std::async;
-   using std::launch;
    using std::unexpected;
 
 
-   auto LabelImageCache::wxImageTask::getImage() noexcept -> ResultWrapper
+   namespace
    {
-      try
+      /// @brief returns a temp file path for writing file_path that no other writer in this process will use
+      ///
+      /// a fetch for a bigger thumbnail can run alongside one for a smaller thumbnail of the same label, and
+      /// sharing a temp file between them fails on Windows.
+      auto uniqueTempPath(const fs::path& file_path) -> fs::path
       {
-         // this is a potentially long, BLOCKING call if file is still being downloaded!
-         auto bytes = getValue();
-         if (!bytes)
-            return unexpected{ bytes.error() };
+         static std::atomic<uint64_t> counter{};
+
+         auto temp_path = file_path;
+         temp_path.replace_extension(ctb::format("{}.{}", counter.fetch_add(1, std::memory_order_relaxed), constants::DOWNLOAD_FILE_EXTENSION));
+         return temp_path;
+      }
+   }
 
-         // initialize a stream with the bytes returned from the task so we can load it into a wxImage
-         wxMemoryInputStream byte_stream(bytes->data(), bytes->size());
+
+   auto LabelImageCache::decodeImage(const Buffer& bytes) noexcept -> std::expected<wxImage, Error>
+   {
+      try
+      {
+         // initialize a stream with the bytes so we can load it into a wxImage
+         wxMemoryInputStream byte_stream(bytes.data(), bytes.size());
          wxImage label_img{};
-         label_img.LoadFile(byte_stream, wxBITMAP_TYPE_JPEG);
+         if (!label_img.LoadFile(byte_stream, wxBITMAP_TYPE_JPEG) or !label_img.IsOk())
+            return unexpected{ Error{ constants::ERROR_STR_LABEL_DECODE_FAILED } };
+
          return label_img;
       }
       catch (...) {
@@ -45,8 +59,17 @@ namespace ctb::app
    }
 
 
-   LabelImageCache::LabelImageCache(fs::path cache_folder) : m_cache_folder{ std::move(cache_folder) }
+   LabelImageCache::LabelImageCache(fs::path cache_folder, TaskExecutorPtr executor, uint64_t max_disk_bytes) : 
+      m_cache_folder{ std::move(cache_folder) }, 
+      m_executor{ std::move(executor) },
+      m_memory_cache{ std::make_shared<MemoryCache>(constants::LABEL_MEMORY_CACHE_BYTES, &LabelImageCache::imageBytes) },
+      m_in_flight{ std::make_shared<InFlightFetches>() }
    {
+      if (!m_executor)
+      {
+         throw Error{ constants::ERROR_STR_NULLPTR_ARG };
+      }
+
       if (m_cache_folder.is_relative() or ( (fs::exists(m_cache_folder) and !fs::is_directory(m_cache_folder)) ))
       {
          throw Error{ constants::ERROR_STR_INVALID_LABEL_CACHE };
@@ -63,22 +86,277 @@ namespace ctb::app
             throw Error{ constants::FMT_ERROR_NO_LABEL_CACHE_FOLDER };
          }
       }
+      m_disk_index = std::make_shared<LabelCacheIndex>(m_cache_folder, max_disk_bytes);
    }
 
 
-   auto LabelImageCache::fetchLabelImage(uint64_t wine_id) -> wxImageTask
+   auto LabelImageCache::fetchLabelImageAsync(uint64_t wine_id, int display_size) -> CoTask<ImagePtr>
    {
       checkShutdown();
 
-      // Choose the appropriate task depending on if the file is found locally or needs to be downloaded.
-      auto file_path = buildLabelPath(m_cache_folder, wine_id);
-      if (fs::exists(file_path))
+      auto thumb_size = thumbnailSize(display_size);
+      if (auto label = m_memory_cache->get(wine_id); label and label->covers(thumb_size))
+         co_return label->image;
+
+      // holding a reference keeps the fetch alive until we're done waiting on it.
+      auto fetch = startFetch(wine_id, thumb_size, Priority::Interactive);
+      co_return co_await fetch->result;
+   }
+
+
+   void LabelImageCache::prefetchLabels(std::span<const uint64_t> wine_ids, int display_size, std::stop_token token) noexcept
+   {
+      try
       {
-         return wxImageTask{ async(launch::deferred, runLoadFileTask, file_path, m_cancel_source.get_token()) };
+         if (!m_cancel_source.stop_possible())
+            return;
+
+         auto thumb_size = thumbnailSize(display_size);
+         for (auto wine_id : wine_ids)
+         {
+            if (token.stop_requested())
+               break;
+
+            if (auto label = m_memory_cache->get(wine_id); !label or !label->covers(thumb_size))
+               startFetch(wine_id, thumb_size, Priority::Background, token);
+         }
+      }
+      catch (...) {
+         log::exception(packageError());
+      }
+   }
+
+
+   auto LabelImageCache::thumbnailSize(int display_size) -> int
+   {
+      auto thumb_size = constants::LABEL_THUMBNAIL_MIN_SIZE;
+      while (thumb_size < display_size and thumb_size < constants::LABEL_THUMBNAIL_MAX_SIZE)
+      {
+         thumb_size *= 2;
+      }
+      return std::min(thumb_size, constants::LABEL_THUMBNAIL_MAX_SIZE);
+   }
+
+
+   auto LabelImageCache::startFetch(uint64_t wine_id, int thumb_size, Priority priority, std::stop_token prefetch_token) -> PendingFetchPtr
+   {
+      PendingFetchPtr fetch{};
+      {
+         std::scoped_lock lock{ m_in_flight->mutex };
+         auto& pending = m_in_flight->fetches[wine_id];
+
+         // a fetch for a smaller thumbnail (e.g. started before the window was resized) can't be used, so we replace
+         // it. It will still complete for anyone already waiting on it.
+         if (pending and pending->thumb_size < thumb_size)
+            pending.reset();
+
+         // if a prefetch for this label is still waiting in the background queue, we start another loader 
+         // at the requested priority so the user isn't stuck waiting behind other prefetches. Whichever loader 
+         // runs first does the work.
+         bool needs_loader = !pending or (priority == Priority::Interactive and pending->priority == Priority::Background and !pending->started);
+         if (!pending)
+         {
+            pending = std::make_shared<PendingFetch>();
+            pending->thumb_size = thumb_size;
+         }
+
+         if (!needs_loader)
+            return pending;
+
+         pending->priority = priority;
+         fetch = pending;
+      }
+
+      // can't start the loader while holding the lock, since it removes itself from the map if it fails immediately
+      runFetch(m_disk_index, m_executor, m_memory_cache, m_in_flight, wine_id, fetch->thumb_size, priority, fetch, m_cancel_source.get_token(), std::move(prefetch_token));
+      return fetch;
+   }
+
+
+   auto LabelImageCache::dropPrefetch(InFlightFetches& in_flight, uint64_t wine_id, const PendingFetchPtr& fetch) -> bool
+   {
+      {
+         // if an interactive request joined this fetch it's no longer just a prefetch, and its priority was upgraded.
+         std::scoped_lock lock{ in_flight.mutex };
+         if (fetch->priority != Priority::Background or fetch->started.exchange(true))
+            return false;
+
+         if (auto it = in_flight.fetches.find(wine_id); it != in_flight.fetches.end() and it->second == fetch)
+            in_flight.fetches.erase(it);
+      }
+
+      // nobody should be waiting on a background fetch, but just in case.
+      fetch->result.setException(std::make_exception_ptr(Error{ constants::ERROR_STR_OPERATION_CANCELED, Error::Category::OperationCanceled }));
+      return true;
+   }
+
+
+   auto LabelImageCache::runFetch(LabelCacheIndexPtr disk_index, TaskExecutorPtr executor, MemoryCachePtr memory_cache, InFlightPtr in_flight,
+                                  uint64_t wine_id, int thumb_size, Priority priority, PendingFetchPtr fetch, std::stop_token token, std::stop_token prefetch_token) -> DetachedTask
+   {
+      ImagePtr image{};
+      std::exception_ptr error{};
+      bool owner{ false };
+      try
+      {
+         co_await schedule(*executor, priority);
+
+         // the prefetch batch this was part of was superseded before we got a thread.
+         if (prefetch_token.stop_requested() and dropPrefetch(*in_flight, wine_id, fetch))
+            co_return;
+
+         // another loader for this fetch already ran
+         owner = !fetch->started.exchange(true);
+         if (!owner)
+            co_return;
+
+         // we're on an executor thread, so decode and scale here rather than in the caller.
+         auto label = loadThumbnail(*disk_index, wine_id, thumb_size, token);
+         image = label.image;
+
+         // don't replace a larger image that another fetch just cached
+         if (auto cached = memory_cache->get(wine_id); !cached or !cached->covers(label.max_thumb_size))
+            memory_cache->put(wine_id, std::move(label));
+      }
+      catch (...) {
+         error = std::current_exception();
+      }
+
+      // if we couldn't even get scheduled, another loader for this fetch may still be handling it.
+      if (!owner and fetch->started.exchange(true))
+         co_return;
+
+      // remove it from the in-flight list before completing, so anyone who misses the result starts a new fetch.
+      {
+         std::scoped_lock lock{ in_flight->mutex };
+         if (auto it = in_flight->fetches.find(wine_id); it != in_flight->fetches.end() and it->second == fetch)
+            in_flight->fetches.erase(it);
+      }
+
+      if (image)
+         fetch->result.setValue(std::move(image));
+      else
+         fetch->result.setException(error);
+   }
+
+
+   auto LabelImageCache::loadThumbnail(LabelCacheIndex& disk_index, uint64_t wine_id, int thumb_size, std::stop_token token) noexcept(false) -> CachedLabel
+   {
+      using FileType = LabelCacheIndex::FileType;
+
+      // Only read files the index says we have. If one turns out to be missing we drop it from the index
+      // and fall back to the next option.
+      auto try_load = [&](FileType type) -> std::optional<Buffer>
+         {
+            if (!disk_index.contains(wine_id, type))
+               return std::nullopt;
+
+            try
+            {
+               auto bytes = runLoadFileTask(disk_index.path(wine_id, type), token);
+               disk_index.touch(wine_id);
+               return bytes;
+            }
+            catch (const Error& err) {
+               if (err.category != Error::Category::FileError)
+                  throw;
+
+               disk_index.remove(wine_id, type);
+               return std::nullopt;
+            }
+         };
+
+      checkStopToken(token);
+      if (auto thumb_bytes = try_load(FileType::Thumbnail))
+      {
+         // a saved thumbnail was scaled to exactly the size it was created for, so if it's smaller than 
+         // what's needed now we have to go back to the original.
+         if (auto thumb = decodeImage(*thumb_bytes))
+         {
+            auto largest = std::max(thumb->GetWidth(), thumb->GetHeight());
+            if (largest >= thumb_size)
+               return CachedLabel{ std::make_shared<const wxImage>(std::move(*thumb)), largest };
+         }
+         else {
+            // if the thumbnail is corrupt we'll just recreate it below
+            log::warn("Label thumbnail for wine {} could not be decoded, recreating it.", wine_id);
+            disk_index.remove(wine_id, FileType::Thumbnail);
+         }
+      }
+
+      auto bytes = try_load(FileType::Label);
+      if (!bytes)
+      {
+         auto label_path = disk_index.path(wine_id, FileType::Label);
+         bytes = runFetchAndSaveLabelTask(label_path, wine_id, token);
+
+         std::error_code ec{};
+         if (fs::exists(label_path, ec))
+            disk_index.add(wine_id, FileType::Label, bytes->size());
+      }
+
+      auto image = decodeImage(*bytes);
+      if (!image)
+         throw Error{ std::move(image.error()) };
+
+      checkStopToken(token);
+      if (!scaleToThumbnail(*image, thumb_size))
+      {
+         // the original is small enough to display at any size
+         return CachedLabel{ std::make_shared<const wxImage>(std::move(*image)), constants::LABEL_THUMBNAIL_MAX_SIZE };
+      }
+
+      // Save to a temp file first so a partially-written thumbnail is never picked up. Failing to 
+      // save it isn't fatal, it just means we'll need to scale the original again next time.
+      auto thumb_path = disk_index.path(wine_id, FileType::Thumbnail);
+      auto temp_path = uniqueTempPath(thumb_path);
+      std::error_code ec{};
+      if (image->SaveFile(wxString{ temp_path.wstring() }, wxBITMAP_TYPE_JPEG))
+      {
+         fs::rename(temp_path, thumb_path, ec);
       }
       else {
-         return wxImageTask{ async(launch::async, runFetchAndSaveLabelTask, m_cache_folder, wine_id, m_cancel_source.get_token()) };
+         ec = std::make_error_code(std::errc::io_error);
+      }
+
+      if (ec)
+      {
+         log::warn("Couldn't save label thumbnail '{}'. {}", thumb_path.generic_string(), ec.message());
+         fs::remove(temp_path, ec);
+      }
+      else if (auto size = fs::file_size(thumb_path, ec); !ec)
+      {
+         disk_index.add(wine_id, FileType::Thumbnail, size);
       }
+      return CachedLabel{ std::make_shared<const wxImage>(std::move(*image)), thumb_size };
+   }
+
+
+   auto LabelImageCache::scaleToThumbnail(wxImage& image, int thumb_size) -> bool
+   {
+      auto width  = image.GetWidth();
+      auto height = image.GetHeight();
+      auto largest = std::max(width, height);
+      if (largest <= thumb_size)
+         return false;
+
+      // preserve aspect ratio. Rounding rather than truncating makes the largest side exactly thumb_size, 
+      // which loadThumbnail() relies on to tell what size a saved thumbnail was created for.
+      auto scale = static_cast<double>(thumb_size) / largest;
+      image.Rescale(std::max(1, static_cast<int>(std::lround(width * scale))), std::max(1, static_cast<int>(std::lround(height * scale))), wxIMAGE_QUALITY_HIGH);
+      return true;
+   }
+
+
+   auto LabelImageCache::imageBytes(const CachedLabel& label) -> size_t
+   {
+      const auto& image = label.image;
+      if (!image or !image->IsOk())
+         return 0;
+
+      constexpr size_t rgb_bytes = 3;
+      auto pixels = static_cast<size_t>(image->GetWidth()) * static_cast<size_t>(image->GetHeight());
+      return pixels * (image->HasAlpha() ? rgb_bytes + 1 : rgb_bytes);
    }
 
 
@@ -90,26 +368,40 @@ namespace ctb::app
 
    void LabelImageCache::shutdown() noexcept
    {
-      // note that since we're currently just using std::async() we can't really join any of the the background tasks
-      // we launched, only the caller holding the future can do that. The best we can do is signal cancellation and
-      // stop accepting new tasks. If we move to a real async/concurrency library we should be able to do better.
+      // the executor is shared so we can't join it here, that happens when the app shuts it down. We just signal
+      // cancellation to our tasks and stop accepting new ones. 
       if (m_cancel_source.stop_possible()) m_cancel_source.request_stop();
+      m_memory_cache->clear();
+      if (m_disk_index)
+         m_disk_index->save();
 
       // now set invalid source, so we won't be able to launch more tasks.
       m_cancel_source = std::stop_source{ std::nostopstate };
    }
 
 
-   auto LabelImageCache::runFetchAndSaveLabelTask(fs::path folder, uint64_t wine_id, std::stop_token token) noexcept(false) -> FetchFileTask::ReturnType
+   auto LabelImageCache::runFetchAndSaveLabelTask(fs::path file_path, uint64_t wine_id, std::stop_token token) noexcept(false) -> FetchFileTask::ReturnType
    {
       try
       {
-         SPDLOG_DEBUG("runFetchAndSaveLabelTask({}, {}) starting execution", folder.generic_string(), wine_id);
+         SPDLOG_DEBUG("runFetchAndSaveLabelTask({}, {}) starting execution", file_path.generic_string(), wine_id);
          checkStopToken(token);
          auto buffer = runLabelDownloadTask(wine_id, token);
 
+         // write to a temp file and rename it, so a partially-written label never ends up in the cache. If 
+         // the rename fails (e.g. another fetch of the same label has the file open), we still have the label,
+         // it just won't be cached on disk.
          checkStopToken(token);
-         saveBinaryFile(buildLabelPath(folder, wine_id), buffer, true);
+         auto temp_path = uniqueTempPath(file_path);
+         saveBinaryFile(temp_path, buffer, true);
+
+         std::error_code ec{};
+         fs::rename(temp_path, file_path, ec);
+         if (ec)
+         {
+            log::warn("Couldn't save label '{}'. {}", file_path.generic_string(), ec.message());
+            fs::remove(temp_path, ec);
+         }
 
          return buffer;
       }
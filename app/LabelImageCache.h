@@ -8,14 +8,21 @@
 #pragma once
 
 #include "App.h"
+#include "LabelCacheIndex.h"
 
+#include <ctb/LruCache.h>
 #include <ctb/tasks/tasks.h>
+#include <ctb/tasks/TaskExecutor.h>
 #include <wx/image.h>
 
+#include <atomic>
 #include <expected>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <string>
 #include <stop_token>
+#include <unordered_map>
 #include <vector>
 
 
@@ -24,6 +31,10 @@ namespace ctb::app
 
    /// @brief manages a disk-based cache of wine label images.
    ///
+   /// The disk cache is indexed (see LabelCacheIndex) and limited in size, the least-recently used labels
+   /// are removed when it goes over budget. Recently-used labels are also kept decoded in a memory cache (limited by size in bytes), so 
+   /// going back to a label that was just displayed doesn't need to re-read or re-decode the file.
+   ///
    /// note that while instances of this class are thread-safe,  you should be careful how 
    /// you use the return value of loadImage() if you're not in the main UI thread, since since
    /// using it with other UI code should only be done from the main UI thread.
@@ -31,58 +42,58 @@ namespace ctb::app
    class LabelImageCache final
    {
    public:
+      /// @brief decoded images are shared with the memory cache, so they're immutable
+      using ImagePtr = std::shared_ptr<const wxImage>;
+
       /// @brief LabelImageCache constructor
       /// 
       /// @param cache_folder - path of folder to use for disk cache. env vars will be expanded
+      /// @param executor - thread pool used to run downloads
+      /// @param max_disk_bytes - size budget for the disk cache
       /// @throws ctb::Error if cache folder doesn't exist and can't be created, or is a relative path. 
-      explicit LabelImageCache(fs::path cache_folder);
+      LabelImageCache(fs::path cache_folder, tasks::TaskExecutorPtr executor, uint64_t max_disk_bytes);
       ~LabelImageCache() noexcept;
 
 
-      /// @brief wxImageTask - adapts FetchFileTask to return wxImage
+      /// @brief Fetch a decoded label image with a coroutine.
       ///
-      /// This wrapper just adds a convenience method for returning the 
-      /// future value as a wxImage instead of raw bytes. 
-      class wxImageTask final : public tasks::FetchFileTask
-      {
-      public:
-         using FetchFileTask = tasks::FetchFileTask;
-         using FutureType    = FetchFileTask::FutureType;
-         using ResultWrapper = std::expected<wxImage, Error>;
-
-         /// @brief getImage() - retrieve the future value from the task as a wxImage
-         /// 
-         /// This is a potentially long, BLOCKING call if file is still being downloaded!
-         ///
-         /// @return expected - the requested wxImage; unexpected - ctb::Error describing the failure
-         auto getImage() noexcept -> ResultWrapper;
-
-         wxImageTask()                               = default;
-         wxImageTask(wxImageTask&&)                  = default;
-         ~wxImageTask() noexcept                     = default;
-         wxImageTask& operator=(wxImageTask&&)       = default;
-         wxImageTask(const wxImageTask&)             = delete;
-         wxImageTask& operator=(const wxImageTask&)  = delete;
-
-      private:
-         /// @brief wxImageTask constructor (private, accessible only from LabelImageCache)
-         explicit wxImageTask(FetchFileTask::FutureType&& t) noexcept : FetchFileTask{ std::move(t) }
-         {}
-         friend class LabelImageCache;
-      };
-
+      /// The returned image is a thumbnail, scaled down to fit within thumbnailSize(display_size) so it can be 
+      /// displayed without further expensive processing. If a large enough image is in the memory cache it's 
+      /// returned immediately. Otherwise the file I/O and/or download, decoding and scaling run on the executor,
+      /// so the awaiting coroutine will be resumed on an executor thread. If the same image is already being 
+      /// fetched at a large enough size (including by prefetchLabels()), this waits for that fetch instead of
+      /// starting another.
+      /// 
+      /// @param wine_id - the wine to get the label for
+      /// @param display_size - the largest dimension the label will be displayed at, in physical pixels.
+      /// @throws ctb::Error if the image couldn't be loaded, downloaded or decoded, or the cache was shut down.
+      auto fetchLabelImageAsync(uint64_t wine_id, int display_size = 0) -> tasks::CoTask<ImagePtr>;
 
-      /// @brief Fetch a label image asynchronously.
+      /// @brief start loading the specified labels into the memory cache, at background priority.
       ///
-      /// Caller can check if result is ready by polling the returned task and 
-      /// then calling getImage() to retrieve the image when it's ready
+      /// Labels that are already cached or being fetched are skipped. This returns immediately, and 
+      /// does nothing if the cache has been shut down. 
       /// 
-      auto fetchLabelImage(uint64_t wine_id) -> wxImageTask;
+      /// Requesting stop on token drops any of these prefetches that haven't started yet, so callers can 
+      /// cancel a batch that's no longer useful (e.g. the selection moved on). A prefetch that someone is
+      /// waiting on through fetchLabelImageAsync() still runs.
+      void prefetchLabels(std::span<const uint64_t> wine_ids, int display_size = 0, std::stop_token token = {}) noexcept;
+
+      /// @brief returns the thumbnail size used for a display size.
+      ///
+      /// Sizes are rounded up to a power of two multiple of LABEL_THUMBNAIL_MIN_SIZE, so a few sizes of thumbnail 
+      /// cover every window size, and limited to LABEL_THUMBNAIL_MAX_SIZE. 
+      static auto thumbnailSize(int display_size) -> int;
 
-      /// @brief shuts down the thread pool, attempting to cancel any remaining tasks. 
+      /// @brief convert JPEG image bytes into a wxImage
+      /// @return the image, or a ctb::Error if it couldn't be decoded
+      static auto decodeImage(const Buffer& bytes) noexcept -> std::expected<wxImage, Error>;
+
+      /// @brief cancels any remaining tasks started by this cache. 
       ///
-      /// this function returns immediately, the shutdown is asynchronous. After calling shutdown,
-      /// any calls to other methods on this instance will throw a ctb::Error.
+      /// this function returns immediately, the tasks will finish asynchronously on the executor (which 
+      /// is responsible for joining them). After calling shutdown, any calls to other methods on this 
+      /// instance will throw a ctb::Error.
       /// 
       void shutdown() noexcept;
 
@@ -92,8 +103,63 @@ namespace ctb::app
       LabelImageCache& operator=(const LabelImageCache&) = delete;
 
    private:
-      const fs::path    m_cache_folder;   // modifying after construction wouldn't be thread-safe anyways
-      std::stop_source  m_cancel_source{};
+      /// @brief a decoded label, and the largest thumbnail size it can be used for without scaling it up
+      struct CachedLabel
+      {
+         ImagePtr image{};
+         int      max_thumb_size{};
+
+         auto covers(int thumb_size) const -> bool
+         {
+            return max_thumb_size >= thumb_size;
+         }
+      };
+
+      using MemoryCache    = LruCache<uint64_t, CachedLabel>;
+      using MemoryCachePtr = std::shared_ptr<MemoryCache>;
+      using Priority       = tasks::TaskExecutor::Priority;
+
+      /// @brief an in-progress fetch, which any number of requests can wait on.
+      struct PendingFetch
+      {
+         tasks::SharedResult<ImagePtr> result{};
+         std::atomic_bool              started{ false }; // set by whichever loader gets to run first
+         Priority                      priority{};
+         int                           thumb_size{};
+      };
+      using PendingFetchPtr = std::shared_ptr<PendingFetch>;
+
+      struct InFlightFetches
+      {
+         std::mutex mutex{};
+         std::unordered_map<uint64_t, PendingFetchPtr> fetches{};
+      };
+      using InFlightPtr = std::shared_ptr<InFlightFetches>;
+
+      const fs::path          m_cache_folder;   // modifying after construction wouldn't be thread-safe anyways
+      tasks::TaskExecutorPtr  m_executor{};
+      LabelCacheIndexPtr      m_disk_index{};
+      MemoryCachePtr          m_memory_cache{}; // shared so coroutines can safely add to it after suspending
+      InFlightPtr             m_in_flight{};    // same
+      std::stop_source        m_cancel_source{};
+
+      /// @brief get the in-progress fetch for a label, starting a new one if there isn't one.
+      ///
+      /// A fetch for a smaller thumbnail is replaced by a new one, the old one still completes for anyone waiting on it.
+      auto startFetch(uint64_t wine_id, int thumb_size, Priority priority, std::stop_token prefetch_token = {}) -> PendingFetchPtr;
+
+      /// @brief coroutine that loads a label on the executor and sets the fetch's result
+      ///
+      /// If prefetch_token is stopped before the loader starts, a background fetch that nobody is waiting on is dropped.
+      static auto runFetch(LabelCacheIndexPtr disk_index, tasks::TaskExecutorPtr executor, MemoryCachePtr memory_cache, InFlightPtr in_flight, 
+                           uint64_t wine_id, int thumb_size, Priority priority, PendingFetchPtr fetch, std::stop_token token, std::stop_token prefetch_token) -> tasks::DetachedTask;
+
+      /// @brief remove a background fetch from the in-flight list if it hasn't started and nobody is waiting on it.
+      /// @return true if the fetch was dropped, false if it still needs to run.
+      static auto dropPrefetch(InFlightFetches& in_flight, uint64_t wine_id, const PendingFetchPtr& fetch) -> bool;
+
+      /// @brief approximate memory used by a decoded image
+      static auto imageBytes(const CachedLabel& label) -> size_t;
 
       void checkShutdown() const noexcept(false)
       {
@@ -101,17 +167,17 @@ namespace ctb::app
             throw Error{ constants::ERROR_STR_LABEL_CACHE_SHUT_DOWN }; 
       }
 
-      static auto buildLabelPath(const fs::path& folder, uint64_t wine_id) -> fs::path
-      {
-         return folder / buildLabelFilename(wine_id);
-      }
+      /// @brief load (or download) a label and return its thumbnail. 
+      /// 
+      /// If a saved thumbnail isn't available or is smaller than thumb_size, the original is scaled down and 
+      /// the thumbnail is saved next to it (replacing the smaller one), so subsequent loads only need to read 
+      /// and decode the smaller file.
+      static auto loadThumbnail(LabelCacheIndex& disk_index, uint64_t wine_id, int thumb_size, std::stop_token token) noexcept(false) -> CachedLabel;
 
-      static auto buildLabelFilename(uint64_t wine_id) -> std::string
-      {
-         constexpr auto image_num = 1;
-         return ctb::format(constants::FMT_LABEL_IMAGE_FILENAME, wine_id, image_num);
-      }
+      /// @brief scale an image down to fit within thumb_size, if needed. 
+      /// @return true if the image was scaled, false if it was already small enough
+      static auto scaleToThumbnail(wxImage& image, int thumb_size) -> bool;
 
-      static auto runFetchAndSaveLabelTask(fs::path folder, uint64_t wine_id, std::stop_token token) noexcept(false) -> tasks::FetchFileTask::ReturnType;
+      static auto runFetchAndSaveLabelTask(fs::path file_path, uint64_t wine_id, std::stop_token token) noexcept(false) -> tasks::FetchFileTask::ReturnType;
    };
 }
\ No newline at end of file
@@ -18,6 +18,8 @@
 #include <ctb/utility_chrono.h>
 #include <ctb/utility_http.h>
 #include <ctb/table_download.h>
+#include <ctb/table_sync.h>
+#include <ctb/TableSyncService.h>
 #include <ctb/model/DatasetEventSource.h>
 #include <ctb/model/CtDatasetLoader.h>
 
@@ -39,10 +41,12 @@
 #include <wx/statusbr.h>
 #include <wx/stockitem.h>
 #include <wx/toolbar.h>
+#include <wx/weakref.h>
 #include <wx/wupdlock.h>
 #include <wx/xrc/xmlres.h>
 
 #include <memory>
+#include <optional>
 
 
 namespace ctb::app
@@ -195,7 +199,9 @@ namespace ctb::app
 
    
    MainFrame::MainFrame() :
-      m_event_source{ DatasetEventSource::create() },
+      // coalesce dataset events and dispatch them from the event loop, so a burst of filter/sort changes 
+      // from one user action only refreshes each view once.
+      m_event_source{ DatasetEventSource::create([this](std::function<void()> flush) { CallAfter(std::move(flush)); }) },
       m_dataset_events{ m_event_source }
    {
    }
@@ -268,6 +274,8 @@ namespace ctb::app
       {
          Center(wxBOTH);
       }
+
+      startBackgroundSync();
    }
 
 
@@ -578,101 +586,148 @@ namespace ctb::app
 
    void MainFrame::onMenuFileSyncData([[maybe_unused]] wxCommandEvent& event) 
    {
-      // TODO: refactor this
       try
       {
-
          TableSyncDialog dlg(this);
          if (dlg.ShowModal() != wxID_OK)
             return;
 
-         wxBusyCursor busy{};
-         ScopedStatusText end_status{ constants::STATUS_DOWNLOAD_COMPLETE, this };
-
-         CtCredentialManager cred_mgr{};
-         const auto* cred_name = constants::CELLARTRACKER_DOT_COM;
-         auto prompt_msg = ctb::format(constants::FMT_CREDENTIALDLG_PROMPT_MSG, cred_name);
-         auto cred_result = cred_mgr.loadCredential(cred_name, prompt_msg, true);
-
-         if (!cred_result)
+         // don't let background sync write the same files while we're downloading. It gets restarted when we're 
+         // done even if the download failed, since the dialog may have changed its settings.
+         m_sync_service.reset();
+         try
          {
-            if (cred_result.error().category == Error::Category::OperationCanceled)
-               return;
-
-            throw Error{ cred_result.error() };
+            syncTables(dlg.selectedTables());
          }
+         catch(...){
+            wxGetApp().displayErrorMessage(packageError(), true);
+         }
+         startBackgroundSync();
+      }
+      catch(...){
+         wxGetApp().displayErrorMessage(packageError(), true);
+      }
+   }
 
-         // If cred doesn't work we need to reprompt so udpate prompt message.
-         prompt_msg = ctb::format(constants::FMT_CREDENTIALDLG_REPROMPT_MSG, cred_name);
 
-         constexpr auto max_percent = 100;
-         wxProgressDialog progress_dlg{"Download Progress", "Downloading Data Files", max_percent, this, wxPD_CAN_ABORT | wxPD_AUTO_HIDE | wxPD_APP_MODAL };
+   void MainFrame::syncTables(std::vector<TableId> tables)
+   {
+      wxBusyCursor busy{};
+      ScopedStatusText end_status{ constants::STATUS_DOWNLOAD_COMPLETE, this };
+
+      CtCredentialManager cred_mgr{};
+      const auto* cred_name = constants::CELLARTRACKER_DOT_COM;
+      auto prompt_msg = ctb::format(constants::FMT_CREDENTIALDLG_PROMPT_MSG, cred_name);
+      auto cred_result = cred_mgr.loadCredential(cred_name, prompt_msg, true);
 
-         ProgressCallback progress_callback = [&progress_dlg] ([[maybe_unused]] int64_t downloadTotal, [[maybe_unused]] int64_t downloadNow,
-                                                                     [[maybe_unused]] int64_t uploadTotal, [[maybe_unused]] int64_t uploadNow,
-                                                                     [[maybe_unused]] intptr_t userdata)
-                                                                     {
-                                                                        return progress_dlg.Pulse();
-                                                                     };
+      if (!cred_result)
+      {
+         if (cred_result.error().category == Error::Category::OperationCanceled)
+            return;
 
-         // For each selected table, download it.
-         for (auto tbl : dlg.selectedTables())
-         {
-            setStatusText(constants::FMT_STATUS_FILE_DOWNLOADING, getTableDescription(tbl));
+         throw Error{ cred_result.error() };
+      }
 
-            DownloadResult result{};
-            result = downloadRawTableData(*cred_result, tbl, DataFormatId::csv, &progress_callback);
+      // If cred doesn't work we need to reprompt so udpate prompt message.
+      prompt_msg = ctb::format(constants::FMT_CREDENTIALDLG_REPROMPT_MSG, cred_name);
+
+      constexpr auto max_percent = 100;
+      wxProgressDialog progress_dlg{"Download Progress", "Downloading Data Files", max_percent, this, wxPD_CAN_ABORT | wxPD_AUTO_HIDE | wxPD_APP_MODAL };
+
+      ProgressCallback progress_callback = [&progress_dlg] ([[maybe_unused]] int64_t downloadTotal, [[maybe_unused]] int64_t downloadNow,
+                                                                  [[maybe_unused]] int64_t uploadTotal, [[maybe_unused]] int64_t uploadNow,
+                                                                  [[maybe_unused]] intptr_t userdata)
+                                                                  {
+                                                                     return progress_dlg.Pulse();
+                                                                  };
+
+      // Download all selected tables concurrently. If the login fails we re-prompt and retry whatever
+      // didn't get downloaded, since a bad credential stops the remaining downloads. Other failures
+      // don't stop the remaining tables, they're collected and reported together when we're done.
+      auto folder = wxGetApp().getDataFolder(AppFolder::Tables);
+      auto pending = std::move(tables);
+      std::vector<TableId> updated_tables{};
+      std::vector<std::pair<TableId, Error>> failures{};
+      bool login_canceled{ false };
+      while (!pending.empty())
+      {
+         setStatusText(constants::FMT_STATUS_FILES_DOWNLOADING, pending.size());
+         auto results = CtDatasetLoader{ folder }.downloadTables(*cred_result, pending, {}, &progress_callback);
 
-            while (!result)
+         // the tables that were downloaded have already been saved, we just need to check for errors.
+         std::vector<TableId> retry{};
+         bool auth_failed{ false };
+         for (auto& [tbl, result] : results)
+         {
+            if (result)
             {
-               auto error = result.error();
-               if (error.error_code == std::to_underlying(HttpStatus::Code::Unauthorized))
-               {
-                  // login failure, need to re-prompt for credentials.
-                  cred_result = cred_mgr.promptCredential(cred_name, prompt_msg, true);
-                  if (cred_result)
-                  {
-                     // got a new cred, try again
-                     result = downloadRawTableData(*cred_result, tbl, DataFormatId::csv, &progress_callback);
-                  }
-                  else{
-                     // user canceled login dialog so just exit out
-                     end_status.message = constants::ERROR_STR_DOWNLOAD_AUTH_FAILURE;
-                     return;
-                  }
-               }
-               else if (error.category == Error::Category::OperationCanceled)
+               if (*result)
                {
-                  // user hit cancel in progress dilaog, so just exit out.
-                  end_status.message = constants::STATUS_DOWNLOAD_CANCELED;
-                  return;
-               }               
-               else {
-                  // some unknown error happened, let user know before bailing.
-                  wxGetApp().displayErrorMessage(result.error());
-                  end_status.message = constants::STATUS_DOWNLOAD_FAILED;
-                  return;
+                  updated_tables.push_back(tbl);
+                  setStatusText(constants::FMT_STATUS_FILE_DOWNLOADED, getTableDescription(tbl));
                }
+               else
+                  setStatusText(constants::FMT_STATUS_FILE_UNCHANGED, getTableDescription(tbl));
+               continue;
+            }
+
+            const auto& error = result.error();
+            if (error.error_code == std::to_underlying(HttpStatus::Code::Unauthorized))
+            {
+               auth_failed = true;
             }
-            // did user ask to save cred?
-            if (cred_result->saveRequested())
+            else if (error.category != Error::Category::OperationCanceled)
             {
-               cred_mgr.saveCredential(*cred_result);
+               failures.emplace_back(tbl, error);
+               continue;
             }
+            retry.push_back(tbl);
+         }
+
+         if (!auth_failed)
+         {
+            // anything not downloaded at this point was canceled by the user.
+            if (!retry.empty())
+               end_status.message = constants::STATUS_DOWNLOAD_CANCELED;
+
+            break;
+         }
 
-            // if we get here we have the data, so save it to file.
-            auto folder = wxGetApp().getDataFolder(AppFolder::Tables);
-            auto file_path{ folder / result->tableName() };
-            file_path.replace_extension(constants::DATA_FILE_EXTENSION);
-            saveTextToFile(file_path, result->data, true);
+         // login failure, need to re-prompt for credentials.
+         auto new_cred = cred_mgr.promptCredential(cred_name, prompt_msg, true);
+         if (!new_cred)
+         {
+            // user canceled login dialog, so skip whatever is left but keep the tables we did get.
+            end_status.message = constants::ERROR_STR_DOWNLOAD_AUTH_FAILURE;
+            login_canceled = true;
+            break;
+         }
+         cred_result = std::move(new_cred);
+         pending = std::move(retry);
+      }
 
-            setStatusText(constants::FMT_STATUS_FILE_DOWNLOADED, getTableDescription(tbl));
+      if (!failures.empty())
+      {
+         std::string failed_tables{};
+         for (const auto& [tbl, error] : failures)
+         {
+            failed_tables += ctb::format(constants::FMT_ERROR_STR_DOWNLOAD_FAILED_ITEM, getTableDescription(tbl), error.formattedMesage());
          }
+         wxGetApp().displayErrorMessage(ctb::format(constants::FMT_ERROR_STR_DOWNLOADS_FAILED, failed_tables), true);
+         end_status.message = constants::STATUS_DOWNLOAD_FAILED;
       }
-      catch(...){
-         wxGetApp().displayErrorMessage(packageError(), true);
+
+      // did user ask to save cred? Don't save one that was rejected and never replaced.
+      if (!login_canceled and cred_result->saveRequested())
+      {
+         cred_mgr.saveCredential(*cred_result);
       }
 
+      // refresh the active dataset if we just downloaded a new version of its table
+      if (auto dataset = getDataset(false); dataset and rng::contains(updated_tables, dataset->getTableId()))
+      {
+         reloadDataset(true);
+      }
    }
 
 
@@ -728,9 +783,7 @@ namespace ctb::app
    {
       try
       {
-         wxBusyCursor busy{};
-         auto options = CtDatasetOptions::retrieveOptions(m_event_source->getDataset());
-         setDataset(loadDataset(options));
+         reloadDataset(true);
       }
       catch(...){
          wxGetApp().displayErrorMessage(packageError(), true);
@@ -1026,6 +1079,63 @@ namespace ctb::app
    }
 
 
+   auto MainFrame::reloadDataset(bool display_errors) -> tasks::DetachedTask
+   {
+      // the window could be destroyed while the table is loading, so after resuming on the main thread
+      // we only access it through the weak ref.
+      wxWeakRef<MainFrame> self{ this };
+      auto dataset = getDataset(false);
+      auto executor = wxGetApp().getTaskExecutor();
+      if (!dataset or !executor)
+         co_return;
+
+      // parsing can take a while so it's done on a worker thread, but a table that was just synced is
+      // usually in the dataset cache already.
+      CtDatasetLoader loader{ wxGetApp().getDataFolder(AppFolder::Tables) };
+      DatasetPtr updated{};
+      std::optional<Error> error{};
+      try
+      {
+         co_await tasks::schedule(*executor, tasks::TaskExecutor::Priority::Interactive);
+         updated = loader.getDataset(dataset->getTableId());
+      }
+      catch (...) {
+         error = packageError();
+      }
+
+      co_await resumeOnMainThread();
+
+      if (error)
+      {
+         if (display_errors and error->category != Error::Category::OperationCanceled)
+            wxGetApp().displayErrorMessage(*error);
+         else
+            log::exception(*error);
+      }
+      // skip the update if the user switched to a different dataset while we were loading
+      else if (self and self->getDataset(false) == dataset)
+      {
+         self->applyReloadedDataset(dataset, updated);
+      }
+   }
+
+
+   void MainFrame::applyReloadedDataset(const DatasetPtr& dataset, const DatasetPtr& updated)
+   {
+      // update the existing dataset in-place if we can, so we keep the current view/selection and only
+      // have to re-sort what changed. If we can't, replace it with the new one using the same options.
+      auto selected_row = m_selected_row == ROW_NONE ? NullableInt{} : NullableInt{ m_selected_row };
+      if (auto result = dataset->applyUpdate(*updated, selected_row))
+      {
+         m_event_source->signal(DatasetEvent::Id::DataUpdate, result->tracked_row);
+      }
+      else {
+         CtDatasetOptions::retrieveOptions(dataset).applyToDataset(updated);
+         setDataset(updated);
+      }
+   }
+
+
    void MainFrame::setDataset(const DatasetPtr& dataset)
    {
       // clean up existing view and dataset. setting dataset to nullptr will fire the DatasetRemoved event so UI elements can
@@ -1046,6 +1156,13 @@ namespace ctb::app
          m_view = DatasetMultiView::create(this, m_event_source);
          m_event_source->signal(DatasetEvent::Id::DatasetInitialize, false);
 
+         // now that the first table is showing, parse the rest in the background so switching to them is instant.
+         if (!m_tables_preloaded)
+         {
+            m_tables_preloaded = true;
+            CallAfter(&MainFrame::startTablePreload);
+         }
+
          // Force a complete redraw of everything
          SetTitle(ctb::format("{} - {}", dataset->getCollectionName(), constants::APP_NAME_LONG));
          Layout();
@@ -1055,6 +1172,94 @@ namespace ctb::app
    }
 
 
+   void MainFrame::startBackgroundSync()
+   {
+      try
+      {
+         m_sync_service.reset();
+
+         // background sync is only enabled if the user asked to sync on startup, and we also need
+         // a saved credential since we can't prompt for one in the background.
+         auto tables = TableSyncDialog::defaultSyncTables();
+         auto cfg = wxGetApp().getConfig(constants::CONFIG_PATH_PREFERENCE_DATASYNC);
+         if (tables.empty() or not cfg->ReadBool(constants::CONFIG_VALUE_SYNC_ON_STARTUP, false))
+            return;
+
+         CtCredentialManager cred_mgr{};
+         auto cred_result = cred_mgr.loadCredential(constants::CELLARTRACKER_DOT_COM);
+         if (!cred_result)
+         {
+            log::info("Background sync disabled, no saved credential. {}", cred_result.error().formattedMesage());
+            return;
+         }
+
+         // results come in on the service's worker thread, so we need to hand them off to the UI thread.
+         auto on_sync = [this](TableSyncResults results)
+            {
+               CallAfter([this, results = std::move(results)] { onBackgroundSyncComplete(results); });
+            };
+         m_sync_service = std::make_unique<TableSyncService>(std::move(*cred_result), wxGetApp().getDataFolder(AppFolder::Tables), on_sync);
+
+         for (auto tbl : tables)
+         {
+            m_sync_service->setSchedule(tbl, TableSyncDialog::syncInterval(tbl));
+         }
+         m_sync_service->syncNow();
+      }
+      catch (...) {
+         log::exception(packageError());
+      }
+   }
+
+
+   void MainFrame::startTablePreload()
+   {
+      try
+      {
+         // queued loads are canceled when the app shuts down the executor on exit.
+         CtDatasetLoader loader{ wxGetApp().getDataFolder(AppFolder::Tables) };
+         auto count = loader.preloadTables(*wxGetApp().getTaskExecutor());
+         log::info("Preloading {} tables in the background.", count);
+      }
+      catch (...) {
+         log::exception(packageError());
+      }
+   }
+
+
+   void MainFrame::onBackgroundSyncComplete(const TableSyncResults& results)
+   {
+      try
+      {
+         std::vector<TableId> updated_tables{};
+         for (const auto& [tbl, result] : results)
+         {
+            if (!result)
+            {
+               log::warn("Background sync of table '{}' failed. {}", getTableDescription(tbl), result.error().formattedMesage());
+
+               // saved credential doesn't work anymore, no point in continuing to try.
+               if (result.error().error_code == std::to_underlying(HttpStatus::Code::Unauthorized))
+                  m_sync_service.reset();
+            }
+            else if (*result)
+            {
+               updated_tables.push_back(tbl);
+            }
+         }
+
+         // swap in the new data if the active dataset's table was updated, this doesn't disrupt the user's view
+         if (auto dataset = getDataset(false); dataset and rng::contains(updated_tables, dataset->getTableId()))
+         {
+            reloadDataset(false);
+         }
+      }
+      catch (...) {
+         log::exception(packageError());
+      }
+   }
+
+
    void MainFrame::updateStatusBarCounts()
    {     
       std::string summary{};
@@ -1072,7 +1277,8 @@ namespace ctb::app
 
       switch (event.event_id)
       {
-         case DatasetEvent::Id::RowSelected:
+         case DatasetEvent::Id::RowSelected:   [[fallthrough]];
+         case DatasetEvent::Id::DataUpdate:
             m_selected_row = event.affected_row.value_or(none);
             break;
 
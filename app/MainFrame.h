@@ -8,7 +8,9 @@
 #pragma once
 
 #include "App.h"
+#include <ctb/TableSyncService.h>
 #include <ctb/model/DatasetEventHandler.h>
+#include <ctb/tasks/CoTask.h>
 
 
 #include <wx/event.h>
@@ -16,6 +18,7 @@
 #include <wx/frame.h>
 
 #include <memory>
+#include <vector>
 
 /// forward declare wx classes to avoid header pollution.
 class wxBoxSizer;
@@ -72,6 +75,8 @@ namespace ctb::app
       wxStatusBar*          m_status_bar{};   // non-owning ptr to statusbar ctrl
       wxToolBar*            m_tool_bar{};     // non-owning ptr to toolbar ctrl
       int                   m_selected_row{ ROW_NONE }; // whether or not a row is selected in the dataset view, for update-UI handlers. -1 means no selection
+      std::unique_ptr<TableSyncService> m_sync_service{}; // background sync, null if it's disabled
+      bool                  m_tables_preloaded{ false }; // whether we've started preloading the other tables yet
 
       /// @brief private ctor called by static create()
       MainFrame();
@@ -124,9 +129,15 @@ namespace ctb::app
       void clearSearchFilter();
       void doSearchFilter();
       auto getDataset(bool throw_on_null = true) -> DatasetPtr;
+      auto reloadDataset(bool display_errors) -> tasks::DetachedTask;
+      void applyReloadedDataset(const DatasetPtr& dataset, const DatasetPtr& updated);
       void setDataset(const DatasetPtr& dataset);
+      void startBackgroundSync();
+      void startTablePreload();
+      void syncTables(std::vector<TableId> tables);
       void updateStatusBarCounts();
 
+      void onBackgroundSyncComplete(const TableSyncResults& results);
       void onDatasetEvent(DatasetEvent event);
    };
 
@@ -78,7 +78,10 @@ namespace ctb::constants
  
    inline constexpr const char* CONFIG_VALUE_DEFAULT_SYNC_TABLES   = "DefaultSyncTables";
    inline constexpr const char* CONFIG_VALUE_SYNC_ON_STARTUP       = "SyncOnStartup";
+   inline constexpr const char* CONFIG_VALUE_SYNC_INTERVAL_MINUTES = "SyncIntervalMinutes";
+   inline constexpr const char* CONFIG_VALUE_FMT_TABLE_SYNC_INTERVAL = "SyncIntervalMinutes{}";
    inline constexpr const char* CONFIG_VALUE_LABEL_CACHE_DIR       = "LabelCacheDir";
+   inline constexpr const char* CONFIG_VALUE_LABEL_CACHE_MAX_MB    = "LabelCacheMaxMB";
    inline constexpr const char* CONFIG_PATH_GRID_OPTIONS           = "/Preferences/GridOptions";
    inline constexpr const char* CONFIG_VALUE_DEFAULT_IN_STOCK_ONLY = "DefaultInStockOnly";
  
@@ -94,9 +97,20 @@ namespace ctb::constants
    inline constexpr const char* FMT_DEFAULT_OPTIONS_SAVED_MSG     = "New default options saved for collection '{}'";
    inline constexpr const char* FMT_LBL_FILTERS_SELECTED          = "{}  ({} selected)";
    inline constexpr const char* FMT_STATUS_FILE_DOWNLOADED        = "Successfully downloaded file '{}'.";
+   inline constexpr const char* FMT_STATUS_FILE_UNCHANGED         = "File '{}' is already up to date.";
    inline constexpr const char* FMT_STATUS_FILE_DOWNLOADING       = "Downloading file '{}'...";
+   inline constexpr const char* FMT_STATUS_FILES_DOWNLOADING      = "Downloading {} files...";
    inline constexpr const char* FMT_TITLE_TYPED_ERROR             = "{} Error";
    inline constexpr const char* FMT_LABEL_IMAGE_FILENAME          = "{}-{}.jpg";
+   inline constexpr const char* FMT_LABEL_THUMBNAIL_FILENAME      = "{}-{}.thumb.jpg";
+   inline constexpr int         LABEL_THUMBNAIL_MIN_SIZE          = 512;
+   inline constexpr int         LABEL_THUMBNAIL_MAX_SIZE          = 2048;
+   inline constexpr long        LABEL_CACHE_MAX_MB_DEFAULT        = 512;
+   inline constexpr const char* LABEL_INDEX_FILENAME              = "label_index.txt";
+   inline constexpr const char* LABEL_INDEX_HEADER                = "ctBrowse label cache index v1";
+   inline constexpr size_t      LABEL_INDEX_SAVE_INTERVAL         = 32;
+   inline constexpr size_t      LABEL_MEMORY_CACHE_BYTES          = 64 * ONE_MB;
+   inline constexpr int         LABEL_PREFETCH_ROWS               = 3;
 
    inline constexpr const char* INFO_MSG_NO_MATCHING_ROWS         = "No rows matched the search text.";
    inline constexpr const char* ERROR_USER_CANCELED               = "User canceled operation.";
@@ -180,14 +194,18 @@ namespace ctb::constants
 
    inline constexpr int  WX_UNSPECIFIED_VALUE                     = -1;
    inline constexpr bool CONFIG_VALUE_IN_STOCK_FILTER_DEFAULT     = true;
+   inline constexpr long CONFIG_VALUE_SYNC_INTERVAL_DEFAULT       = 60;
 
    // app-specific error messages.
    inline constexpr const char* ERROR_STR_LABEL_CACHE_SHUT_DOWN     = "Label cache object is shutting down.";
+   inline constexpr const char* ERROR_STR_LABEL_DECODE_FAILED       = "Label image could not be decoded.";
    inline constexpr const char* ERROR_STR_NO_CONFIG_STORE           = "No configuration store available.";
    inline constexpr const char* ERROR_STR_ORPHANED_SIZER            = "No configuration store available.";
    inline constexpr const char* ERROR_STR_DETAILS_VIEW_NULL_DATASET = "Creating a details view requires a valid dataset";
 
    inline constexpr const char* FMT_ERROR_STR_INVALID_DETAIL_DETAIL = "No DetailsView factory for table id '{}'";
+   inline constexpr const char* FMT_ERROR_STR_DOWNLOADS_FAILED      = "The following files could not be downloaded:\n\n{}";
+   inline constexpr const char* FMT_ERROR_STR_DOWNLOAD_FAILED_ITEM  = "{}: {}\n";
 
    inline constexpr const char* CT_COOKIE_SECRET_NAME           = "CTSession";
 
@@ -2,13 +2,7 @@
 
 
 #include <wx/sizer.h>
-
-
-namespace ctb::constants
-{
-   constexpr auto LABEL_TIMER_RETRY_INTERVAL = 33;
-
-} // namespace ctb::constants
+#include <wx/weakref.h>
 
 
 namespace ctb::app
@@ -49,57 +43,25 @@ namespace ctb::app
       SetScaleMode(wxStaticBitmap::Scale_AspectFit);
 
       // hook up event handlers
-      m_label_timer.Bind(wxEVT_TIMER, &LabelImageCtrl::onLabelTimer, this);
       m_dataset_events.addHandler(DatasetEvent::Id::RowSelected, [this](const DatasetEvent& event) { fetchImage(event); });
    }
 
 
-   void LabelImageCtrl::checkLabelResult()
+   void LabelImageCtrl::displayLabel(const MaybeImage& result)
    {
-      using namespace tasks;
-
-      if (auto& result = m_image_result)
+      try
       {
-         switch (result->poll(0ms))
-         {
-         case wxImageTask::Status::Deferred: [[fallthrough]];
-         case wxImageTask::Status::Finished:
-            displayLabel();
-            [[fallthrough]];
-
-         case wxImageTask::Status::Invalid:
-            m_image_result = {};
-            break;
-
-         case wxImageTask::Status::Running:
-            m_label_timer.StartOnce(constants::LABEL_TIMER_RETRY_INTERVAL);
-            break;
-
-         default:
-            assert("Bug, new enum value wasn't accounted for" and false);
-            break;
-         }
-      }
-   }
+         if (!result)
+            throw Error{ result.error() }; 
 
+         const auto& image = *result;
+         if (!image or !image->IsOk())
+            throw Error{ constants::ERROR_STR_NULLPTR_ARG };
 
-   void LabelImageCtrl::displayLabel()
-   {
-      try
-      {
-         if (m_image_result)
-         {
-            auto result = m_image_result->getImage();
-            if (!result)
-               // the move is necessary because expected::error() returns a reference that would immediately go out of scope.
-               throw Error{ std::move(result.error()) }; 
-
-            wxBitmap bmp{ *result };
-            SetBitmap(bmp);
-            Show();
-            GetParent()->Layout(); // required since the images vary in size
-            //GetParent()->SendSizeEvent();
-         }
+         wxBitmap bmp{ *image };
+         SetBitmap(bmp);
+         Show();
+         GetParent()->Layout(); // required since the images vary in size
       }
       catch (...)
       {
@@ -112,22 +74,77 @@ namespace ctb::app
    }
 
 
-   void LabelImageCtrl::onLabelTimer(wxTimerEvent&)
-   {
-      checkLabelResult();
-   }
-
-
    void LabelImageCtrl::fetchImage(const DatasetEvent& event)
    {
       // we always hide it, it will be shown once we successfully retrieve the image
       Hide();
+      ++m_fetch_id;
+
+      // prefetches for the previous selection's neighbors that haven't started yet aren't worth running now.
+      m_prefetch_source.request_stop();
+      m_prefetch_source = std::stop_source{};
+
       if (event.dataset && event.affected_row.has_value())
       {
          auto wine_id = event.dataset->getProperty(event.affected_row.value(), CtProp::iWineId).asUInt64().value_or(0);
-         m_image_result = m_cache->fetchLabelImage(wine_id);
-         checkLabelResult();
+         loadLabel(wine_id, m_fetch_id);
+         prefetchNeighbors(*event.dataset, event.affected_row.value());
       }
    }
 
+
+   void LabelImageCtrl::prefetchNeighbors(const IDataset& dataset, int row)
+   {
+      // warm the labels for the rows on either side of the selection, closest first, since the
+      // user is likely to move to one of them next.
+      auto row_count = dataset.rowCount();
+      std::vector<uint64_t> wine_ids{};
+      for (auto offset = 1; offset <= constants::LABEL_PREFETCH_ROWS; ++offset)
+      {
+         for (auto neighbor : { row + offset, row - offset })
+         {
+            if (neighbor < 0 or neighbor >= row_count)
+               continue;
+
+            if (auto wine_id = dataset.getProperty(neighbor, CtProp::iWineId).asUInt64())
+               wine_ids.push_back(*wine_id);
+         }
+      }
+      m_cache->prefetchLabels(wine_ids, displaySize(), m_prefetch_source.get_token());
+   }
+
+
+   auto LabelImageCtrl::displaySize() const -> int
+   {
+      // we're hidden while fetching and sized to fit the image, so our own size doesn't tell us anything. The 
+      // label can be at most as wide as our parent, so that's the size we ask for.
+      auto* parent = GetParent();
+      return parent->ToPhys(parent->GetClientSize().GetWidth());
+   }
+
+
+   auto LabelImageCtrl::loadLabel(uint64_t wine_id, uint64_t fetch_id) -> tasks::DetachedTask
+   {
+      // the window could be destroyed while we're waiting on the cache, so after resuming we only
+      // access it through the weak ref.
+      wxWeakRef<LabelImageCtrl> self{ this };
+      auto cache = m_cache;
+      auto display_size = displaySize();
+
+      MaybeImage result{};
+      try
+      {
+         result = co_await cache->fetchLabelImageAsync(wine_id, display_size);
+      }
+      catch (...) {
+         result = std::unexpected{ packageError() };
+      }
+
+      co_await resumeOnMainThread();
+
+      // ignore the result if the selection changed while we were waiting for it.
+      if (self and self->m_fetch_id == fetch_id)
+         self->displayLabel(result);
+   }
+
 } // namespace ctb::app
\ No newline at end of file
@@ -5,7 +5,6 @@
 #include <ctb/model/DatasetEventHandler.h>
 
 #include <wx/generic/statbmpg.h>
-#include <wx/timer.h>
 
 
 class wxSizer;
@@ -31,18 +30,18 @@ namespace ctb::app
 
       void createWindow(wxWindow* parent);
 
-      using wxImageTask    = LabelImageCache::wxImageTask;
-      using MaybeImageTask = std::optional<wxImageTask>;
+      using MaybeImage = std::expected<LabelImageCache::ImagePtr, Error>;
 
       LabelCachePtr          m_cache{};
       DatasetEventHandler    m_dataset_events;
-      MaybeImageTask         m_image_result{};
-      wxTimer                m_label_timer{};
+      uint64_t               m_fetch_id{};   // incremented for each fetch, so we can ignore results that were superseded
+      std::stop_source       m_prefetch_source{}; // cancels the current batch of neighbor prefetches when the selection changes
 
-      void checkLabelResult();
-      void displayLabel();
-      void onLabelTimer(wxTimerEvent& event);
+      void displayLabel(const MaybeImage& result);
       void fetchImage(const DatasetEvent& event);
+      void prefetchNeighbors(const IDataset& dataset, int row);
+      auto displaySize() const -> int;
+      auto loadLabel(uint64_t wine_id, uint64_t fetch_id) -> tasks::DetachedTask;
    };
 
 
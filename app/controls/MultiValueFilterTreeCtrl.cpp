@@ -2,6 +2,7 @@
 
 #include <ctb/interfaces/IDatasetEventSink.h>
 #include <ctb/interfaces/IDatasetEventSource.h>
+#include <ctb/model/DatasetTransaction.h>
 
 #include <wx/artprov.h>
 #include <wx/clipbrd.h>
@@ -117,6 +118,7 @@ namespace ctb::app
          switch (event.event_id)
          {
             case DatasetEvent::Id::Filter:              [[fallthrough]];
+            case DatasetEvent::Id::DataUpdate:          [[fallthrough]];
             case DatasetEvent::Id::DatasetInitialize:
                onDatasetInitialize(*event.dataset.get());
                break;
@@ -213,9 +215,8 @@ namespace ctb::app
    {
       try 
       {
-         auto dataset = m_dataset_events.getDataset(true);
-         dataset->multivalFilters().clear();
-         m_dataset_events.signal_source(DatasetEvent::Id::Filter, true);
+         DatasetTransaction transaction{ m_dataset_events.getDataset(true) };
+         transaction.clearMultiValueFilters().commit(*m_dataset_events.getSource());
       }
       catch(...){
          wxGetApp().displayErrorMessage(packageError(), true);
@@ -70,17 +70,10 @@ namespace ctb::app
          m_table_selection_ctrl->InsertItems(wxToArrayString(table_descriptions), 0);
 
          // need to read some defaults from config settings.
-         auto cfg = wxGetApp().getConfig(constants::CONFIG_PATH_PREFERENCE_DATASYNC);
+         m_table_selection_val = defaultSyncTables() | vws::transform([](TableId tbl) { return enum_integer(tbl); })
+                                                     | rng::to<wxArrayInt>();
 
-         // default-selected tables are stored as a string of enum values (e.g int values not names)
-         // delimited by ENUM_DELIMTER. The default value is the table enum value 0 (List)
-         m_table_selection_val = std::string_view{ cfg->Read(constants::CONFIG_VALUE_DEFAULT_SYNC_TABLES, "0").wx_str() } // read the config value
-            | vws::split(ENUM_DELIMETER)                                                                                 // split by token ';'
-            | vws::transform([] (auto subrange) { return std::string_view(subrange.begin(), subrange.end()); })          // convert subranges to string_view's
-            | vws::transform([] (std::string_view sv) { return from_str<int>(sv); })                                     // convert string view to from_chars() result
-            | vws::filter([] (auto opt) { return opt.has_value(); })                                                     // filter out results that have no value
-            | vws::transform([](auto opt) { return opt.value(); })                                                       // retrieve actual value from remaining results
-            | rng::to<wxArrayInt>();                                                                                     // convert to array
+         auto cfg = wxGetApp().getConfig(constants::CONFIG_PATH_PREFERENCE_DATASYNC);
 
          // whether the "Sync on Startup" box should be checked.
          m_startup_sync_val = cfg->ReadBool(constants::CONFIG_VALUE_SYNC_ON_STARTUP, false);
@@ -95,6 +88,33 @@ namespace ctb::app
    }
 
 
+   std::vector<TableId> TableSyncDialog::defaultSyncTables()
+   {
+      auto cfg = wxGetApp().getConfig(constants::CONFIG_PATH_PREFERENCE_DATASYNC);
+
+      // default-selected tables are stored as a string of enum values (e.g int values not names)
+      // delimited by ENUM_DELIMTER. The default value is the table enum value 0 (List)
+      return std::string_view{ cfg->Read(constants::CONFIG_VALUE_DEFAULT_SYNC_TABLES, "0").wx_str() } // read the config value
+         | vws::split(ENUM_DELIMETER)                                                                  // split by token ';'
+         | vws::transform([] (auto subrange) { return std::string_view(subrange.begin(), subrange.end()); }) // convert subranges to string_view's
+         | vws::transform([] (std::string_view sv) { return from_str<int>(sv); })                      // convert string view to from_chars() result
+         | vws::filter([] (auto opt) { return opt.has_value(); })                                      // filter out results that have no value
+         | vws::transform([] (auto opt) { return enum_cast<TableId>(opt.value()); })                   // convert to optional<TableId>
+         | vws::filter([] (auto maybe_enum) { return maybe_enum.has_value(); })                        // filter only valid values
+         | vws::transform([] (auto maybe_enum) { return maybe_enum.value(); })                         // retrieve actual value
+         | rng::to<std::vector>();
+   }
+
+
+   std::chrono::minutes TableSyncDialog::syncInterval(TableId tbl)
+   {
+      auto cfg = wxGetApp().getConfig(constants::CONFIG_PATH_PREFERENCE_DATASYNC);
+      auto default_interval = cfg->ReadLong(constants::CONFIG_VALUE_SYNC_INTERVAL_MINUTES, constants::CONFIG_VALUE_SYNC_INTERVAL_DEFAULT);
+      auto table_key = ctb::format(constants::CONFIG_VALUE_FMT_TABLE_SYNC_INTERVAL, enum_name(tbl));
+      return std::chrono::minutes{ cfg->ReadLong(wxString{ table_key }, default_interval) };
+   }
+
+
    std::vector<TableId> TableSyncDialog::selectedTables() const
    {
       using namespace vws;
@@ -13,6 +13,7 @@
 #include <wx/checkbox.h>
 #include <wx/checklst.h>
 #include <wx/dialog.h>
+#include <chrono>
 #include <vector>
 
 
@@ -51,6 +52,17 @@ namespace ctb::app
       ///
       [[nodiscard]] std::vector<TableId> selectedTables() const;
 
+      /// @brief retrieve the list of tables the user saved as the default selection
+      ///
+      [[nodiscard]] static std::vector<TableId> defaultSyncTables();
+
+      /// @brief retrieve how often a table should be synced in the background
+      ///
+      /// Each table can have its own interval (e.g. "SyncIntervalMinutesList"), tables that don't have
+      /// one use the "SyncIntervalMinutes" setting, which defaults to CONFIG_VALUE_SYNC_INTERVAL_DEFAULT.
+      ///
+      [[nodiscard]] static std::chrono::minutes syncInterval(TableId tbl);
+
       /// @brief  indicates whether the user checked "Save as Default" in the dialog
       ///
       bool saveAsDefault() const noexcept { return m_save_default_val; }
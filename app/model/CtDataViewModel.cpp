@@ -1,6 +1,8 @@
 
 #include "model/CtDataViewModel.h"
 
+#include <algorithm>
+
 namespace ctb::app
 {
 
@@ -25,10 +27,96 @@ namespace ctb::app
 
    void CtDataViewModel::reQuery()
    {
+      clearCache();
       Cleared();
    }
 
 
+   auto CtDataViewModel::prefetchRows() -> bool
+   {
+      syncRowCount();
+      if (m_cache.empty())
+         return false;
+
+      // work outward from the last requested row, favoring rows below it since that's the usual scroll direction
+      auto formatted = int64_t{};
+      auto window_end = m_cache_first + std::ssize(m_cache);
+      for (auto offset = int64_t{}; formatted < PREFETCH_BATCH_ROWS and (m_last_row + offset < window_end or m_last_row - offset >= m_cache_first); ++offset)
+      {
+         for (auto row : { m_last_row + offset, m_last_row - offset - 1 })
+         {
+            // both rows at this offset could be unformatted, so the batch can fill up between them
+            if (formatted >= PREFETCH_BATCH_ROWS)
+               break;
+
+            if (row < m_cache_first or row >= window_end)
+               continue;
+
+            auto& cached = m_cache[static_cast<size_t>(row - m_cache_first)];
+            if (cached.empty())
+            {
+               cached = formatRow(row);
+               ++formatted;
+            }
+         }
+      }
+      return formatted >= PREFETCH_BATCH_ROWS;
+   }
+
+
+   void CtDataViewModel::clearCache()
+   {
+      m_row_count   = m_dataset ? m_dataset->rowCount() : 0;
+      m_col_count   = m_dataset ? std::ssize(m_dataset->listColumns()) : 0;
+      m_cache_first = 0;
+      m_last_row    = 0;
+      m_cache.clear();
+   }
+
+
+   void CtDataViewModel::syncRowCount() const
+   {
+      auto row_count = m_dataset ? m_dataset->rowCount() : 0;
+      if (row_count == m_row_count)
+         return;
+
+      m_row_count   = row_count;
+      m_cache_first = 0;
+      m_last_row    = 0;
+      m_cache.clear();
+   }
+
+
+   auto CtDataViewModel::cachedRow(int64_t row) const -> const CachedRow&
+   {
+      // if the row is outside our window, move the window so the row is a quarter of the way into it.
+      if (row < m_cache_first or row >= m_cache_first + std::ssize(m_cache))
+      {
+         m_cache_first = std::max(int64_t{}, row - CACHE_WINDOW_ROWS / 4);
+         m_cache.assign(static_cast<size_t>(std::min(CACHE_WINDOW_ROWS, m_row_count - m_cache_first)), CachedRow{});
+      }
+
+      m_last_row = row;
+      auto& cached = m_cache[static_cast<size_t>(row - m_cache_first)];
+      if (cached.empty())
+      {
+         cached = formatRow(row);
+      }
+      return cached;
+   }
+
+
+   auto CtDataViewModel::formatRow(int64_t row) const -> CachedRow
+   {
+      auto rec_idx = static_cast<int>(row);
+      return m_dataset->listColumns() | vws::transform([this, rec_idx](const CtListColumn& list_col) -> wxString
+                                                       {
+                                                          return list_col.getDisplayValue(m_dataset->getProperty(rec_idx, list_col.prop_id));
+                                                       })
+                                      | rng::to<CachedRow>();
+   }
+
+
    void CtDataViewModel::associateView(wxDataViewCtrl* view) 
    {
       view->AssociateModel(this);
@@ -37,18 +125,15 @@ namespace ctb::app
 
    void CtDataViewModel::GetValueByRow(wxVariant& variant, unsigned row, unsigned col) const 
    {
-      auto row_count = m_dataset->rowCount();
-      auto col_count = std::ssize(m_dataset->listColumns());
-      if ( row >= row_count or col >= col_count)
+      syncRowCount();
+      if ( !m_dataset or row >= m_row_count or col >= m_col_count)
       {
-         SPDLOG_DEBUG("CtDataViewModel::GetValueByRow() called with invalid coordinates {} (max {}), {} (max{}).", row, row_count, col, col_count);
+         SPDLOG_DEBUG("CtDataViewModel::GetValueByRow() called with invalid coordinates {} (max {}), {} (max{}).", row, m_row_count, col, m_col_count);
          return;
       }
-      const auto& list_col = m_dataset->listColumns()[col];
 
-      // format as string and return it to caller
-      auto& val = m_dataset->getProperty(static_cast<int>(row), list_col.prop_id);
-      variant = list_col.getDisplayValue(val);
+      // return the cached display text, formatting the row first if necessary.
+      variant = cachedRow(row)[col];
    }
 
 
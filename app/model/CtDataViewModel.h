@@ -4,14 +4,29 @@
 
 #include <wx/dataview.h>
 
+#include <vector>
+
 namespace ctb::app
 {
+   /// @brief virtual list model providing display values for a dataset's list columns
+   ///
+   /// display text is cached for a window of rows around the most recently requested row, so
+   /// repainting or scrolling within the window doesn't need to go back to the dataset. Rows
+   /// ahead of/behind the requested row are formatted by prefetchRows(), which the view calls
+   /// when idle. The dataset isn't threadsafe, so all of this happens on the main thread.
+   /// 
    class CtDataViewModel final : protected wxDataViewVirtualListModel
    {
    public:
       using base     = wxDataViewVirtualListModel;
       using ModelPtr = wxObjectDataPtr<CtDataViewModel>;
 
+      /// @brief number of rows in the display cache window
+      static inline constexpr int64_t CACHE_WINDOW_ROWS = 512;
+
+      /// @brief max number of rows formatted per call to prefetchRows()
+      static inline constexpr int64_t PREFETCH_BATCH_ROWS = 32;
+
       /// @brief Create a new model for the supplied DatasetPtr
       /// @return smart ptr to the newly created model object
       [[nodiscard]] static auto create(const DatasetPtr& dataset = {}) -> ModelPtr;
@@ -25,6 +40,10 @@ namespace ctb::app
       /// @brief Forces a refresh of the data view after large changes to underlying dataset
       void reQuery();
 
+      /// @brief formats display text for rows near the most recently displayed row.
+      /// @return true if there are more rows in the cache window to format, false if it's complete.
+      auto prefetchRows() -> bool;
+
       /// @brief associate a data view ctrl with this model. we only support one associated view, last call wins.
       void associateView(wxDataViewCtrl* view);
 
@@ -33,7 +52,14 @@ namespace ctb::app
       using base::GetRow;
 
    private:
-      DatasetPtr       m_dataset{};
+      using CachedRow = std::vector<wxString>;  // empty if the row hasn't been formatted yet
+
+      DatasetPtr                     m_dataset{};
+      mutable int64_t                m_row_count{};       // row count the cache window was built for, see syncRowCount()
+      int64_t                        m_col_count{};
+      mutable std::vector<CachedRow> m_cache{};           // display text for the rows in the cache window
+      mutable int64_t                m_cache_first{};     // first row in the cache window
+      mutable int64_t                m_last_row{};        // most recently requested row, prefetching works outward from here
 
       explicit CtDataViewModel(DatasetPtr dataset = {}) : m_dataset{ std::move(dataset) }
       {}
@@ -46,6 +72,16 @@ namespace ctb::app
       void GetValueByRow(wxVariant& variant, unsigned row, unsigned col) const override;
       auto SetValueByRow(const wxVariant&, unsigned, unsigned) -> bool override;
       auto GetCount() const -> unsigned int override;
+
+      void clearCache();
+
+      /// @brief discard the cache window if the dataset's row count no longer matches it
+      ///
+      /// the dataset is filtered/sorted before the (coalesced) event telling us to reQuery() arrives, so a 
+      /// repaint in between could otherwise ask the dataset for rows that are no longer in its view.
+      void syncRowCount() const;
+      auto cachedRow(int64_t row) const -> const CachedRow&;
+      auto formatRow(int64_t row) const -> CachedRow;
    };
 
    using DataViewModelPtr = CtDataViewModel::ModelPtr;
@@ -3,7 +3,7 @@
 #include "json_serialization.h"
 
 #include <ctb/model/CtDataset.h>
-#include <ctb/model/ScopedDatasetFreeze.h>
+#include <ctb/model/DatasetTransaction.h>
 
 
 namespace ctb::app
@@ -26,7 +26,8 @@ namespace ctb::app
       if (nullptr == dataset)
          return false;
 
-      ScopedDatasetFreeze freeze{ dataset };
+      // stage the sort and filters so the dataset only gets re-sorted/filtered once.
+      DatasetTransaction transaction{ dataset };
 
       bool all_good = true;
 
@@ -50,34 +51,24 @@ namespace ctb::app
       // make sure the saved sort's primary property is one supported by the dataset 
       if (active_sort.sort_props.size() > 0 and dataset->hasProperty(active_sort.sort_props[0]))
       {
-         dataset->applySort(active_sort);
+         transaction.setSort(active_sort);
       }
       else {
          failed(ctb::format("Dataset Options being applied to dataset '{}' contains invalid sort specification, this is probably a bug or an invalid options file.", enum_name(table_id)));
       }
 
-      /// filter manager class stores the filters in a map, so we have to extract the key
-      /// when applying the saved filters. For multi-val it's the CtPropId, for prop filters
-      /// it's the filter name.
-      dataset->multivalFilters().assignFilters(multival_filters | 
-         vws::transform([](auto&& filter)
-            { 
-               return std::make_pair(filter.prop_id, std::forward<decltype(filter)>(filter)); 
-            }
-         ));
-      dataset->propFilters().assignFilters(prop_filters | 
-         vws::transform([](auto&& filter)
-            {  
-               return std::make_pair(filter.filter_name, std::forward<decltype(filter)>(filter)); 
-            }
-         ));
-
-      if (dataset->multivalFilters().size() < multival_filters.size() or dataset->propFilters().size() < prop_filters.size())
+      /// filters are staged in maps, keyed by CtPropId for multi-val and filter name for prop filters.
+      transaction.assignMultiValueFilters(multival_filters);
+      transaction.assignPropertyFilters(prop_filters);
+
+      const auto& staged = transaction.changes();
+      if (staged.multival_filters->size() < multival_filters.size() or staged.prop_filters->size() < prop_filters.size())
       {
          // probably dupe key in hand-edited file, not really sure how else this could happen.
          failed("One or more filters in the Dataset Options could not be applied to the Dataset"); 
       }
 
+      transaction.commit();
       return all_good;
    }
 
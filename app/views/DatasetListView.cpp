@@ -49,6 +49,7 @@ namespace ctb::app
       Bind(wxEVT_DATAVIEW_SELECTION_CHANGED,         &DatasetListView::onSelectionChanged, this);
       Bind(wxEVT_COMMAND_DATAVIEW_ITEM_CONTEXT_MENU, &DatasetListView::onWineContextMenu,  this);
       Bind(wxEVT_DATAVIEW_ITEM_ACTIVATED,            &DatasetListView::onWineDoubleClick,  this);
+      Bind(wxEVT_IDLE,                               &DatasetListView::onIdle,             this);
 
       m_dataset_events.setDefaultHandler([this](const DatasetEvent& event) { onDatasetEvent(event);  });
    }
@@ -99,6 +100,7 @@ namespace ctb::app
       wxWindowUpdateLocker freeze_updates{ this };
 
       // re-associate the model with the new dataset (nullptr is OK)
+      m_selected_row_id.reset();
       m_model->setDataset(dataset);
       m_model->associateView(this);
       if (dataset)
@@ -115,12 +117,18 @@ namespace ctb::app
 
 
    void DatasetListView::selectFirstRow()
+   {
+      selectRow(0);
+   }
+
+
+   void DatasetListView::selectRow(int row)
    {
       auto dataset = m_model->getDataset();
-      if (!dataset or dataset->rowCount() == 0)
+      if (!dataset or dataset->rowCount() <= row)
          return;
 
-      auto item = m_model->GetItem(0);
+      auto item = m_model->GetItem(static_cast<unsigned int>(row));
       Select(item);
       EnsureVisible(item);
       SetFocus();
@@ -128,6 +136,18 @@ namespace ctb::app
    }
 
 
+   void DatasetListView::restoreSelection()
+   {
+      // row ids survive sorting and filtering, so this finds the previously selected record without searching the view.
+      auto dataset = m_model->getDataset();
+      auto row = (dataset and m_selected_row_id) ? dataset->rowIndexOf(*m_selected_row_id) : NullableInt{};
+      if (row)
+         selectRow(*row);
+      else
+         selectFirstRow();
+   }
+
+
    void DatasetListView::onDatasetEvent(DatasetEvent event)
    {
       switch (event.event_id)
@@ -143,8 +163,20 @@ namespace ctb::app
          case DatasetEvent::Id::Sort:   [[fallthrough]];
          case DatasetEvent::Id::Filter: [[fallthrough]];
          case DatasetEvent::Id::SubStringFilter:
+            // keep the same record selected if it's still in the view
             m_model->reQuery();
-            selectFirstRow();
+            restoreSelection();
+            break;
+
+         case DatasetEvent::Id::DataUpdate:
+            // keep the same record selected if it's still in the view. Row ids don't survive an update, 
+            // so the dataset tells us where the selected record ended up instead.
+            m_selected_row_id.reset();
+            m_model->reQuery();
+            if (event.affected_row)
+               selectRow(*event.affected_row);
+            else
+               selectFirstRow();
             break;
 
          case DatasetEvent::Id::RowSelected:
@@ -156,6 +188,16 @@ namespace ctb::app
    }
 
 
+   void DatasetListView::onIdle(wxIdleEvent& event)
+   {
+      // fill in the model's display cache around the visible rows while we have nothing better to do.
+      if (m_model->prefetchRows())
+         event.RequestMore();
+
+      event.Skip();
+   }
+
+
    void DatasetListView::onSelectionChanged(wxDataViewEvent& event)
    {
       try 
@@ -164,7 +206,13 @@ namespace ctb::app
 
          auto row = static_cast<int>(m_model->GetRow(event.GetItem()));
          if (row >= 0)
+         {
+            auto dataset = m_model->getDataset();
+            if (dataset and row < dataset->rowCount())
+               m_selected_row_id = dataset->getRowId(row);
+
             m_dataset_events.signal_source(DatasetEvent::Id::RowSelected, false, row);
+         }
       }
       catch (...) {
          wxGetApp().displayErrorMessage(packageError());
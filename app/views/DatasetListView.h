@@ -12,6 +12,8 @@
 
 #include <ctb/model/DatasetEventHandler.h>
 
+#include <optional>
+
 namespace ctb::app
 {
    /// @brief Panel view class for displaying all the wines in a collection in list-view format.
@@ -34,8 +36,11 @@ namespace ctb::app
       ~DatasetListView() noexcept override = default;
 
    private:
+      using MaybeRowId = std::optional<IDataset::RowId>;
+
       DatasetEventHandler  m_dataset_events;
       DataViewModelPtr     m_model{};
+      MaybeRowId           m_selected_row_id{};   // id of the selected record, so it can be reselected after the view changes
 
       /// @brief private ctor used by static create()
       explicit DatasetListView(DatasetEventSourcePtr source) : 
@@ -47,8 +52,11 @@ namespace ctb::app
       void configureColumns();
       void setDataset(const DatasetPtr& dataset);
       void selectFirstRow();
+      void selectRow(int row);
+      void restoreSelection();
 
       void onDatasetEvent(DatasetEvent event);
+      void onIdle(wxIdleEvent& event);
       void onSelectionChanged(wxDataViewEvent& event);
       void onWineContextMenu(wxDataViewEvent& event);
       void onWineDoubleClick(wxDataViewEvent& event);
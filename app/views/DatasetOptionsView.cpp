@@ -13,7 +13,7 @@
 #include "views/DatasetOptionsView.h"
 #include "wx_helpers.h"
 
-#include <ctb/model/ScopedDatasetFreeze.h>
+#include <ctb/model/DatasetTransaction.h>
 #include <ctb/utility_chrono.h>
 
 #include <wx/button.h>
@@ -205,16 +205,17 @@ namespace ctb::app
       // For any property filters that we don't have UI for, we need to remove them from the dataset. Shouldn't happen 
       // but might in the case of filters persisted to file from an earlier version.
       {
-         ScopedDatasetFreeze freeze{ event.dataset };
+         DatasetTransaction transaction{ event.dataset };
          auto active_filter_names = vws::keys(event.dataset->propFilters().activeFilters()) | rng::to<StringSet>();
          for (const auto& name : active_filter_names)
          {
             if (!m_supported_filters.contains(name))
             {
                wxGetApp().displayFormattedMessage("Removing unsupported filter '{}'", name);
-               event.dataset->propFilters().removeFilter(name);
+               transaction.removePropertyFilter(name);
             }
          }
+         transaction.commit();
       }
      
       TransferDataToWindow();
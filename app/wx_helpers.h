@@ -11,8 +11,12 @@
 #include "ctb/utility.h"
 #include "ctb/utility_templates.h"
 
+#include <wx/app.h>
 #include <wx/arrstr.h>
 #include <wx/config.h>
+#include <wx/thread.h>
+
+#include <coroutine>
 
 
 namespace ctb::app
@@ -110,4 +114,30 @@ namespace ctb::app
    };
 
 
+   /// @brief awaitable that resumes the awaiting coroutine on the main UI thread.
+   ///
+   /// The resumption is queued with CallAfter(), so it runs from the event loop. If we're already
+   /// on the main thread the coroutine just continues without suspending. Note that if the app exits 
+   /// before the event is processed the coroutine is never resumed, so don't await this while holding
+   /// anything that needs cleanup.
+   ///
+   struct MainThreadAwaiter
+   {
+      auto await_ready() const noexcept -> bool { return wxIsMainThread(); }
+
+      void await_suspend(std::coroutine_handle<> handle) const
+      {
+         wxTheApp->CallAfter([handle] { handle.resume(); });
+      }
+
+      void await_resume() const noexcept {}
+   };
+
+   /// @brief co_await the return value to continue the current coroutine on the main UI thread.
+   inline auto resumeOnMainThread() noexcept -> MainThreadAwaiter
+   {
+      return {};
+   }
+
+
 } // namespace ctb::app
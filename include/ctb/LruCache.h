@@ -0,0 +1,172 @@
+/*********************************************************************
+ * @file       LruCache.h
+ *
+ * @brief      declaration for the LruCache template class
+ *
+ * @copyright  Copyright © 2025 Jeff Kohn. All rights reserved.
+ *********************************************************************/
+#pragma once
+
+#include "ctb/ctb.h"
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+
+namespace ctb
+{
+
+   /// @brief thread-safe least-recently-used cache with a size budget.
+   ///
+   /// The budget is in whatever units the size function returns (typically bytes), rather than a 
+   /// count of entries, since the entries we cache can vary a lot in size. When adding an entry would
+   /// go over budget, the least-recently-used entries are evicted until it fits. An entry that's bigger
+   /// than the whole budget is never cached.
+   ///
+   /// Values are returned by copy, so ValueT should be cheap to copy (e.g. a shared_ptr).
+   ///
+   template<typename KeyT, typename ValueT>
+   class LruCache final
+   {
+   public:
+      using key_type   = KeyT;
+      using value_type = ValueT;
+      using SizeFunc   = std::function<size_t(const ValueT&)>;
+
+      /// @brief construct an empty cache
+      /// @param budget - max total size of all entries
+      /// @param size_func - returns the size of an entry
+      LruCache(size_t budget, SizeFunc size_func) : m_budget{ budget }, m_size_func{ std::move(size_func) }
+      {}
+
+      /// @brief retrieve an entry from the cache, marking it as most-recently used.
+      /// @return the value if found, std::nullopt otherwise
+      auto get(const KeyT& key) -> std::optional<ValueT>
+      {
+         std::scoped_lock lock{ m_mutex };
+
+         auto it = m_index.find(key);
+         if (it == m_index.end())
+            return std::nullopt;
+
+         m_entries.splice(m_entries.begin(), m_entries, it->second);
+         return it->second->value;
+      }
+
+      /// @brief check whether an entry is in the cache, without affecting its LRU position
+      auto contains(const KeyT& key) const -> bool
+      {
+         std::scoped_lock lock{ m_mutex };
+         return m_index.contains(key);
+      }
+
+      /// @brief add or replace an entry in the cache, evicting older entries as needed to stay in budget.
+      void put(const KeyT& key, ValueT value)
+      {
+         auto size = m_size_func(value);
+
+         std::scoped_lock lock{ m_mutex };
+         eraseEntry(key);
+         if (size > m_budget)
+            return;
+
+         m_entries.emplace_front(key, std::move(value), size);
+         m_index[key] = m_entries.begin();
+         m_total_size += size;
+         trimToBudget();
+      }
+
+      /// @brief remove an entry from the cache, if present
+      void erase(const KeyT& key)
+      {
+         std::scoped_lock lock{ m_mutex };
+         eraseEntry(key);
+      }
+
+      /// @brief remove all entries from the cache
+      void clear()
+      {
+         std::scoped_lock lock{ m_mutex };
+         m_index.clear();
+         m_entries.clear();
+         m_total_size = 0;
+      }
+
+      /// @brief change the budget, evicting entries if the cache is now over budget.
+      void setBudget(size_t budget)
+      {
+         std::scoped_lock lock{ m_mutex };
+         m_budget = budget;
+         trimToBudget();
+      }
+
+      auto budget() const -> size_t
+      {
+         std::scoped_lock lock{ m_mutex };
+         return m_budget;
+      }
+
+      /// @brief returns the combined size of all entries in the cache
+      auto totalSize() const -> size_t
+      {
+         std::scoped_lock lock{ m_mutex };
+         return m_total_size;
+      }
+
+      /// @brief returns the number of entries in the cache
+      auto count() const -> size_t
+      {
+         std::scoped_lock lock{ m_mutex };
+         return m_entries.size();
+      }
+
+      LruCache() = delete;
+      LruCache(const LruCache&) = delete;
+      LruCache(LruCache&&) = delete;
+      LruCache& operator=(const LruCache&) = delete;
+      LruCache& operator=(LruCache&&) = delete;
+      ~LruCache() noexcept = default;
+
+   private:
+      struct Entry
+      {
+         KeyT   key;
+         ValueT value;
+         size_t size;
+      };
+      using Entries = std::list<Entry>;
+
+      mutable std::mutex  m_mutex{};
+      Entries             m_entries{};   // most-recently used first
+      std::unordered_map<KeyT, typename Entries::iterator> m_index{};
+      size_t              m_budget{};
+      size_t              m_total_size{};
+      SizeFunc            m_size_func{};
+
+      void eraseEntry(const KeyT& key)
+      {
+         auto it = m_index.find(key);
+         if (it == m_index.end())
+            return;
+
+         m_total_size -= it->second->size;
+         m_entries.erase(it->second);
+         m_index.erase(it);
+      }
+
+      void trimToBudget()
+      {
+         while (m_total_size > m_budget and !m_entries.empty())
+         {
+            auto& oldest = m_entries.back();
+            m_total_size -= oldest.size;
+            m_index.erase(oldest.key);
+            m_entries.pop_back();
+         }
+      }
+   };
+
+} // namespace ctb
@@ -0,0 +1,96 @@
+/*******************************************************************
+ * @file TableSyncService.h
+ *
+ * @brief Header file for the TableSyncService class
+ * 
+ * @copyright Copyright © 2025 Jeff Kohn. All rights reserved. 
+ *******************************************************************/
+#pragma once
+
+#include "ctb/ctb.h"
+#include "ctb/CredentialWrapper.h"
+#include "ctb/table_sync.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+
+namespace ctb
+{
+   /// @brief Service that periodically syncs data tables from CT in the background.
+   ///
+   /// Each table can be given its own sync interval. The service runs a single worker thread that sleeps until
+   /// the next table is due (or syncNow() is called), then downloads every table that's due using 
+   /// CtDatasetLoader::downloadTables(), so updated tables are parsed into the dataset cache as they arrive.
+   /// 
+   /// The completion callback is called ON THE WORKER THREAD, so UI code will need to marshal the results over to
+   /// the main thread before touching any UI or dataset objects. 
+   /// 
+   /// Destroying the service cancels any in-progress downloads and joins the worker thread, the completion
+   /// callback will not be called after the destructor returns.
+   ///
+   class TableSyncService final
+   {
+   public:
+      using Interval     = std::chrono::minutes;
+      using SyncCallback = std::function<void(TableSyncResults results)>;
+
+      /// @brief construct the service and start its worker thread
+      ///
+      /// No tables will be synced until they're added with setSchedule(), or syncNow() is called.
+      /// 
+      /// @param cred        - credential used for all downloads
+      /// @param data_folder - folder to save the tables to
+      /// @param on_sync     - callback that receives the results of each sync. Called on the worker thread.
+      TableSyncService(CredentialWrapper&& cred, fs::path data_folder, SyncCallback on_sync);
+
+      /// @brief set how often a table should be synced
+      ///
+      /// An interval of zero means the table will only be synced when syncNow() is called. The first
+      /// sync for a newly added table is one interval from now.
+      void setSchedule(TableId tbl, Interval interval);
+
+      /// @brief remove a table from the sync schedule.
+      void removeSchedule(TableId tbl);
+
+      /// @brief sync all scheduled tables as soon as possible, regardless of when they're next due.
+      void syncNow();
+
+      /// @brief destructor cancels any in-progress sync and waits for the worker thread to exit
+      ~TableSyncService() noexcept;
+
+      TableSyncService() = delete;
+      TableSyncService(const TableSyncService&) = delete;
+      TableSyncService(TableSyncService&&) = delete;
+      TableSyncService& operator=(const TableSyncService&) = delete;
+      TableSyncService& operator=(TableSyncService&&) = delete;
+
+   private:
+      using Clock = std::chrono::steady_clock;
+
+      struct Schedule
+      {
+         Interval          interval{};
+         Clock::time_point next_due{ Clock::time_point::max() };
+      };
+
+      CredentialWrapper           m_cred;
+      fs::path                    m_data_folder{};
+      SyncCallback                m_on_sync{};
+      std::map<TableId, Schedule> m_schedule{};
+      bool                        m_sync_now{ false };
+      std::mutex                  m_mutex{};
+      std::condition_variable_any m_wakeup{};
+      std::jthread                m_worker{};   // must be declared last, so it's stopped before anything it uses is destroyed.
+
+      void run(std::stop_token token);
+      auto nextDue() const -> Clock::time_point;
+      auto takeDueTables() -> std::vector<TableId>;
+   };
+
+
+} // namespace ctb
@@ -61,19 +61,21 @@ namespace ctb
       { t.end()         } -> std::same_as<typename T::iterator>;
       { t.find(key)     } -> std::same_as<typename T::iterator>;
       { t.contains(key) } -> std::same_as<bool>;
-      { t[key]          } -> std::assignable_from<typename T::mapped_type>;
+      { t[key]          } -> std::convertible_to<const typename T::mapped_type&>;
    };
 
 
    /// @brief Concept for a traits type defining the schema for a TableRecordType instantiation
    ///
    template <typename T> 
-   concept RecordTraitsType = requires (typename T::Prop pid, typename T::PropertyMap props)
+   concept RecordTraitsType = requires (typename T::Prop pid, typename T::MutablePropertyMap props)
    {
       { T::Schema.find(pid)->second } -> std::same_as<const typename T::FieldSchema&>;
       { T::DefaultListColumns[0]    } -> std::same_as<const typename T::ListColumn&>;
       { T::AvailableSorts[0]        } -> std::same_as<const typename T::TableSort&>;
       { T::MultiValueFilters[0]     } -> std::same_as<const typename T::MultiValueFilter&>;
+      { T::PrimaryKey[0]            } -> std::same_as<const typename T::Prop&>;
+      { T::ComputedFields[0]        } -> std::same_as<const typename T::ComputedField&>;
       { T::getTableName()           } -> std::same_as<std::string_view>;
       { T::hasProperty(pid)         } -> std::same_as<bool>;
 
@@ -22,10 +22,12 @@ namespace ctb::constants
    inline constexpr const char* FMT_URL_CT_DRINK_REMOVE     = "https://www.cellartracker.com/barcode.asp?iWine={}";
    inline constexpr const char* FMT_URL_CT_EDIT_ORDER       = "https://www.cellartracker.com/purchase.asp?iWine={}&iPurchase={}";
    inline constexpr const char* FMT_URL_CT_DRINK_WINDOW     = "https://www.cellartracker.com/editpersonal.asp?iWine={}";
-   inline constexpr const char* FMT_URL_CT_TABLE            = "https://www.cellartracker.com/xlquery.asp?User={}&Password={}&Format={}&Table={}";
+   inline constexpr const char* FMT_URL_CT_TABLE            = "{}?User={}&Password={}&Format={}&Table={}";
    inline constexpr const char* FMT_URL_CT_VINTAGES         = "https://www.cellartracker.com/list.asp?Table=List&fInStock=0&iUserOverride=0&Wine={}";
    inline constexpr const char* FMT_URL_CT_WINE_DETAILS     = "https://www.cellartracker.com/wine.asp?iWine={}";
 
+   inline constexpr const char* URL_CT_TABLE                = "https://www.cellartracker.com/xlquery.asp";
+
    inline constexpr const char* HTML_ELEM_LABEL_PHOTO       = "label_photo";
    inline constexpr const char* HTML_ATTR_SRC               = "src";
 
@@ -33,6 +35,8 @@ namespace ctb::constants
    inline constexpr const char* CT_PASSWORD                 = "CT_PASSWORD";
    inline constexpr const char* CURRENT_DIRECTORY           = ".";
    inline constexpr const char* DATA_FILE_EXTENSION         = "csv";
+   inline constexpr const char* DOWNLOAD_FILE_EXTENSION     = "download";
+   inline constexpr const char* VALIDATORS_FILE_SUFFIX      = ".validators";
    inline constexpr int         MAX_ENV_VAR_LENGTH          = 128;
 
    // column labels
@@ -86,6 +90,11 @@ namespace ctb::constants
    inline constexpr const char* HTTP_PARAM_TABLE            = "Table";
    inline constexpr const char* HTTP_PARAM_FORMAT           = "Format";
    inline constexpr int         HTTP_TIMEOUT_SEC            = 30;
+   inline constexpr int         HTTP_TABLE_TIMEOUT_SEC      = 600;
+   inline constexpr size_t      SYNC_MAX_CONCURRENT_DOWNLOADS = 4;
+   inline constexpr int         SYNC_PROGRESS_INTERVAL_MS   = 100;
+   inline constexpr size_t      TASK_EXECUTOR_MAX_THREADS   = 4;
+   inline constexpr size_t      DATASET_CACHE_MAX_TABLES    = 8;
    inline constexpr const char* HTTP_PARAM_KEY_REFERRER     = "Referrer";
    inline constexpr const char* HTTP_PARAM_VAL_REFERRER     = "/default.asp";
    inline constexpr const char* HTTP_PARAM_KEY_USER         = "szUser";
@@ -210,6 +219,8 @@ namespace ctb::constants
 
 
    inline constexpr auto     ONE_MB                               = 1024 * 1024;
+   inline constexpr size_t   STREAM_PARSE_BATCH_BYTES             = ONE_MB / 4;
+   inline constexpr uint32_t MAX_TABLE_FILE_BYTES                 = ONE_MB * 512;
    inline constexpr uint16_t CT_NULL_YEAR                         =        9999;
 
 
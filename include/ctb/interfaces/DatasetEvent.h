@@ -28,6 +28,7 @@ namespace ctb
          Filter,             /// fired when a dataset has been filtered
          SubStringFilter,    /// fired when a substring filter has been applied to the dataset
          RowSelected,        /// fired when the user selects a row
+         DataUpdate,         /// fired when a dataset's records have been updated in-place. affected_row is the new index of the selected row, if any
       };
 
       /// @brief Identifier for the type of event this object represents.
@@ -14,12 +14,56 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 
 
 namespace ctb
 {
+   /// @brief summary of the changes made to a dataset by IDataset::applyUpdate()
+   struct DatasetUpdateResult
+   {
+      size_t      inserted{};
+      size_t      updated{};
+      size_t      deleted{};
+      NullableInt tracked_row{};  /// new index of the row passed to applyUpdate(), null if it's no longer in the current view
+   };
+
+
+   /// @brief a set of sort/filter changes to apply to a dataset in a single pass, see IDataset::applyChanges()
+   ///
+   /// Each member that has a value replaces the corresponding dataset setting; members without a value 
+   /// leave that setting unchanged. DatasetTransaction is the usual way to build one of these.
+   struct DatasetChanges
+   {
+      using MultiValueFilters = CtMultiValueFilterMgr::FilterMap;
+      using PropertyFilters   = CtPropertyFilterMgr::FilterMap;
+
+      std::optional<CtTableSort>       sort{};
+      std::optional<MultiValueFilters> multival_filters{};
+      std::optional<PropertyFilters>   prop_filters{};
+      std::optional<std::string>       substring_filter{};   /// an empty string clears the substring filter
+      std::optional<CtProp>            substring_prop{};     /// column to search for substring_filter, or all list columns if empty
+
+      /// @brief returns true if there are no changes to apply
+      auto empty() const noexcept -> bool
+      {
+         return !sort and !multival_filters and !prop_filters and !substring_filter;
+      }
+   };
+
+
+   /// @brief summary of what actually changed when IDataset::applyChanges() was called
+   struct DatasetChangeResult
+   {
+      bool sort_changed{};       /// the active sort was changed
+      bool filters_changed{};    /// the multi-value and/or property filters were replaced
+      bool substring_changed{};  /// the substring filter was applied or cleared
+      bool substring_matched{};  /// a new substring filter was applied. False if it matched nothing (or none was requested)
+   };
+
+
    /// @brief Data model class that provides a base implementation for accessing CellarTracker data files
    /// 
    class IDataset
@@ -36,6 +80,7 @@ namespace ctb
       using ListColumnSpan      = CtListColumnSpan;
       using TableSort           = CtTableSort;
       using TableSortSpan       = CtTableSortSpan;
+      using RowId               = size_t;
 
       /// @brief Returns the TableId enum for this dataset's underlying table.
       virtual auto getTableId() const -> TableId = 0;
@@ -154,6 +199,45 @@ namespace ctb
       /// values to only those from records that match the filter.
       [[nodiscard]] virtual auto getDistinctValues(CtProp prop_id, std::function<bool(const PropertyMap&)> custom_filter) const -> PropertyValueSet = 0;
 
+      /// @brief Find all of the records for a wine, whether or not they match the active filters.
+      /// 
+      /// This uses a hash index on iWineId that's built the first time it's needed and shared by every dataset 
+      /// for the same table, so it's a constant-time lookup rather than a scan. The visitor is called with each 
+      /// matching record's properties, in table order. References to those values remain valid for as long as 
+      /// references returned by getProperty() would.
+      /// 
+      /// @param wine_id - the iWineId to look for
+      /// @param visitor - called for each matching record, can be empty if you only need the count
+      /// @return the number of matching records
+      virtual auto findWineRecords(uint64_t wine_id, const std::function<void(const PropertyMap&)>& visitor) const -> size_t = 0;
+
+      /// @brief returns the properties that uniquely identify a record in this dataset, see findRowId()
+      virtual auto primaryKey() const -> std::span<const Prop> = 0;
+
+      /// @brief returns the id of the record at the specified row in the current view
+      /// 
+      /// A record's id doesn't change when the dataset is sorted or filtered, so unlike the row index it can 
+      /// be used to find the same record again afterward (see rowIndexOf()). Ids are only valid until the 
+      /// dataset's records are replaced by applyUpdate(), use the primary key to find a record after that.
+      virtual auto getRowId(int rec_idx) const -> RowId = 0;
+
+      /// @brief find the id of the record with the specified primary key, whether or not it matches the active filters.
+      /// 
+      /// This uses a hash index that's built the first time it's needed and shared by every dataset for the same 
+      /// table, so it's a constant-time lookup rather than a scan.
+      /// 
+      /// @param key - values for the properties returned by primaryKey(), in the same order
+      /// @return the id of the matching record, or std::nullopt if there isn't one
+      virtual auto findRowId(std::span<const PropertyVal> key) const -> std::optional<RowId> = 0;
+
+      /// @brief returns the row index of a record in the current view
+      /// 
+      /// The first lookup after the view changes (sort, filter, update) maps every record to its row in a single 
+      /// pass, after which lookups are constant-time until the view changes again. 
+      /// 
+      /// @return the row index, or null if the record isn't in the current view (e.g. it's been filtered out)
+      virtual auto rowIndexOf(RowId row_id) const -> NullableInt = 0;
+
       /// @brief returns the number of records in the underlying dataset
       /// @param filtered_only - if true, only records matching currently active filters will be counted. If false, 
       virtual auto rowCount(bool filtered_only = true) const -> int64_t = 0;
@@ -167,6 +251,30 @@ namespace ctb
       ///  is not currently frozen, this will be a no-op (in which case dataset will NOT be refreshed)
       virtual void unfreezeData() = 0;
 
+      /// @brief Apply a set of sort/filter changes, recomputing the view only once
+      ///
+      /// This is equivalent to making each change individually, except the sort and filters are only applied 
+      /// once at the end (and the records are only re-sorted if the sort actually changed). A substring filter 
+      /// that matches nothing is not applied, the same as filterBySubstring(). If the dataset is frozen, the 
+      /// changes are stored but won't be applied until unfreezeData() is called.
+      /// 
+      /// @return summary of what changed, which callers can use to decide which DatasetEvent(s) to signal.
+      virtual auto applyChanges(const DatasetChanges& changes) -> DatasetChangeResult = 0;
+
+      /// @brief Replace this dataset's records with the records from a newer version of the same table, in-place
+      ///
+      /// Records are matched on the table's primary key, and only records that were inserted or updated need
+      /// to be sorted and filtered, so the cost is proportional to what changed. The active sort and filters are
+      /// unchanged. Records are moved out of updated_data, which will be empty afterward.
+      /// 
+      /// @param updated_data - dataset containing the new version of this dataset's table
+      /// @param tracked_row  - optional row in the current view, whose index after the update will be returned in the result
+      /// 
+      /// @return summary of the changes, or std::nullopt if the records couldn't be matched (different table, or 
+      ///         missing/duplicate keys). In that case neither dataset is modified, and you should use updated_data
+      ///         to replace this dataset instead.
+      virtual auto applyUpdate(IDataset& updated_data, NullableInt tracked_row = {}) -> std::optional<DatasetUpdateResult> = 0;
+
       /// @brief destructor
       virtual ~IDataset() noexcept = default;
    };
@@ -27,6 +27,14 @@ namespace ctb
       /// propagate back to caller.
       virtual void notify(DatasetEvent event) = 0;
 
+      /// @brief returns whether this sink wants notifications for the specified event type.
+      ///
+      /// Event sources check this before calling notify(), so sinks that only handle a few event
+      /// types can skip calls that would be no-ops. The default accepts every event.
+      virtual auto wantsEvent([[maybe_unused]] DatasetEvent::Id event_id) const noexcept -> bool
+      {
+         return true;
+      }
 
       /// @brief virtual destructor
       virtual ~IDatasetEventSink() noexcept = default;
@@ -12,9 +12,13 @@
 #include "ctb/tables/detail/PropertyFilter.h"
 #include "ctb/tables/detail/FilterManager.h"
 #include "ctb/tables/detail/SubStringFilter.h"
+#include "ctb/tables/detail/TableDiff.h"
 
+#include <cassert>
 #include <map>
+#include <memory>
 #include <optional>
+#include <span>
 
 namespace ctb
 {
@@ -34,6 +38,7 @@ namespace ctb
    public:
       using base                = IDataset;
       using DataTable           = DataTableT;
+      using DataTablePtr        = std::shared_ptr<const DataTable>;
       using FieldSchama         = base::FieldSchema;
       using ListColumn          = base::ListColumn;
       using ListColumnSpan      = base::ListColumnSpan;
@@ -44,7 +49,9 @@ namespace ctb
       using PropertyFilterMgr   = base::PropertyFilterMgr;
       using PropertyMap         = base::PropertyMap;
       using PropertyValueSet    = base::PropertyValueSet;
+      using PrimaryKey          = DataTable::PrimaryKey;
       using Record              = DataTable::value_type;
+      using RowId               = base::RowId;
       using SubStringFilter     = detail::SubStringFilter<Record>;
       using TableSort           = base::TableSort;
       using TableSortSpan       = base::TableSortSpan;
@@ -55,6 +62,23 @@ namespace ctb
       /// @return shared_ptr to the requested object
       static auto create(DataTable data) -> DatasetPtr
       {
+         return create(std::make_shared<const DataTable>(std::move(data)));
+      }
+
+      /// @brief Create a data model object for a table that may be shared with other datasets
+      /// 
+      /// Table data is never modified by a dataset (sorting and filtering only affect the dataset's views), 
+      /// so any number of datasets can share the same table, each with its own sort and filters.
+      /// 
+      /// @return shared_ptr to the requested object
+      /// @throws ctb::Error if data == nullptr
+      static auto create(DataTablePtr data) -> DatasetPtr
+      {
+         if (!data)
+         {
+            assert("data cannot be nullptr" and false);
+            throw Error{ Error::Category::ArgumentError, constants::ERROR_STR_NULLPTR_ARG };
+         }
          return DatasetPtr{ static_cast<IDataset*>(new CtDataset{ std::move(data) }) };
       }
 
@@ -245,11 +269,7 @@ namespace ctb
       ///  case the filter was not applied. 
       auto filterBySubstring(std::string_view substr) -> bool override
       {
-         // this overload searches all columns in the current list view, so get the prop_id's 
-         auto cols = listColumns() | vws::transform([](const CtListColumn& disp_col) -> auto { return disp_col.prop_id; })
-                                   | rng::to<std::vector>();
-
-         return applySubStringFilter(SubStringFilter{ std::string{substr}, cols });
+         return applySubStringFilter(makeSubStringFilter(substr, std::nullopt));
       }
 
       /// @brief Apply a search filter that does substring matching on the specified column
@@ -261,8 +281,7 @@ namespace ctb
       ///  case the filter was not applied. 
       auto filterBySubstring(std::string_view substr, CtProp prop_id) -> bool override
       {
-         auto cols = std::vector{ prop_id };
-         return applySubStringFilter(SubStringFilter{ std::string{substr}, cols });
+         return applySubStringFilter(makeSubStringFilter(substr, prop_id));
       }
 
       /// @brief clear the substring filter
@@ -272,6 +291,73 @@ namespace ctb
          applyFilters();
       }
 
+      /// @brief Apply a set of sort/filter changes, recomputing the view only once
+      auto applyChanges(const DatasetChanges& changes) -> DatasetChangeResult override
+      {
+         DatasetChangeResult result{};
+         if (changes.empty())
+            return result;
+
+         // the filter managers call applyFilters() on every change, so stay frozen while we update them
+         const bool was_frozen = std::exchange(m_frozen, true);
+         try
+         {
+            if (changes.sort and *changes.sort != m_current_sort)
+            {
+               m_current_sort = *changes.sort;
+               result.sort_changed = true;
+            }
+            if (changes.multival_filters)
+            {
+               m_mval_filters.assignFilters(*changes.multival_filters);
+               result.filters_changed = true;
+            }
+            if (changes.prop_filters)
+            {
+               m_prop_filters.assignFilters(*changes.prop_filters);
+               result.filters_changed = true;
+            }
+         }
+         catch(...){
+            m_frozen = was_frozen;
+            throw;
+         }
+         m_frozen = was_frozen;
+
+         MaybeSubStringFilter substring_filter{};
+         if (changes.substring_filter)
+         {
+            result.substring_changed = true;
+            m_substring_filter = std::nullopt;
+            if (!changes.substring_filter->empty())
+            {
+               substring_filter = makeSubStringFilter(*changes.substring_filter, changes.substring_prop);
+            }
+         }
+
+         if (m_frozen)
+         {
+            // unfreezeData() will do a full refresh, so all we need to do is store the new state.
+            m_substring_filter = std::move(substring_filter);
+            result.substring_matched = m_substring_filter.has_value();
+            return result;
+         }
+
+         if (result.sort_changed)
+         {
+            sortRecords();
+         }
+         if (result.sort_changed or result.filters_changed or result.substring_changed)
+         {
+            applyFilters();
+         }
+         if (substring_filter)
+         {
+            result.substring_matched = narrowBySubString(*substring_filter);
+         }
+         return result;
+      }
+
       /// @brief Check whether the current dataset supports the given property
       /// 
       /// Since getProperty() will return a null value for missing properties, calling this function
@@ -300,8 +386,9 @@ namespace ctb
       {
          assert(rowCount(true) > rec_idx and "This is a logic bug, invalid index should never happen here.");
 
-         const auto& record = m_current_view->at(static_cast<size_t>(rec_idx));
-         return record[prop_id];
+         m_data->materialize(prop_id);
+         const auto* record = m_current_view->at(static_cast<size_t>(rec_idx));
+         return (*record)[prop_id];
       }
 
       /// @brief Get a list of all distinct values from the table for the specified property.
@@ -312,9 +399,10 @@ namespace ctb
          PropertyValueSet values{};
          if (hasProperty(prop_id))
          {
-            for (const Record& rec : use_current_filters? *m_current_view : m_data)
+            m_data->materialize(prop_id);
+            for (const Record* rec : use_current_filters? *m_current_view : m_sorted_view)
             {
-               values.emplace(rec[prop_id]);
+               values.emplace((*rec)[prop_id]);
             }
          }
          return values;
@@ -338,18 +426,171 @@ namespace ctb
                return result;
             };
 
-         return vws::all(m_data) | vws::transform([](auto&& rec) { return rec.getProperties(); }) 
+         // we don't know which properties the custom filter looks at
+         m_data->materializeAll();
+         return vws::all(*m_data) | vws::transform([](const Record& rec) { return rec.getProperties(); }) 
                                  | vws::filter(custom_filter)
                                  | vws::transform(extractor)
                                  | rng::to<PropertyValueSet>();
       }
 
+      /// @brief Find all of the records for a wine, whether or not they match the active filters.
+      /// @return the number of matching records
+      auto findWineRecords(uint64_t wine_id, const std::function<void(const PropertyMap&)>& visitor) const -> size_t override
+      {
+         auto rows = m_data->wineIdIndex().find(wine_id);
+         if (visitor and not rows.empty())
+         {
+            // we don't know which properties the visitor looks at
+            m_data->materializeAll();
+            for (auto row : rows)
+            {
+               visitor((*m_data)[row].getProperties());
+            }
+         }
+         return rows.size();
+      }
+
+      /// @brief returns the properties that uniquely identify a record in this dataset
+      auto primaryKey() const -> std::span<const Prop> override
+      {
+         return Traits::PrimaryKey;
+      }
+
+      /// @brief returns the id of the record at the specified row in the current view, which is its index in the table.
+      auto getRowId(int rec_idx) const -> RowId override
+      {
+         assert(rowCount(true) > rec_idx and "This is a logic bug, invalid index should never happen here.");
+
+         return m_data->indexOf(m_current_view->at(static_cast<size_t>(rec_idx)));
+      }
+
+      /// @brief find the id of the record with the specified primary key, whether or not it matches the active filters.
+      /// @return the id of the matching record, or std::nullopt if there isn't one
+      auto findRowId(std::span<const PropertyVal> key) const -> std::optional<RowId> override
+      {
+         if (key.size() != Traits::PrimaryKey.size())
+            return std::nullopt;
+
+         PrimaryKey table_key{};
+         rng::copy(key, table_key.begin());
+         auto rows = m_data->keyIndex().find(table_key);
+         if (rows.empty())
+            return std::nullopt;
+
+         return rows.front();
+      }
+
+      /// @brief returns the row index of a record in the current view, or null if it isn't in the view
+      auto rowIndexOf(RowId row_id) const -> NullableInt override
+      {
+         if (row_id >= m_data->size())
+            return std::nullopt;
+
+         if (m_view_rows.size() != m_data->size())
+         {
+            m_view_rows.assign(m_data->size(), ViewRowNone);
+            for (auto&& [row, rec] : vws::enumerate(*m_current_view))
+            {
+               m_view_rows[m_data->indexOf(rec)] = static_cast<int32_t>(row);
+            }
+         }
+
+         auto row = m_view_rows[row_id];
+         return row == ViewRowNone ? NullableInt{} : NullableInt{ row };
+      }
+
       /// @brief returns the number of rows in the underlying dataset
       /// @param filtered_only - if true, the count will only include rows matching any active filters.
       ///                        if false, the count will always be the raw/total number of rows
       auto rowCount(bool filtered_only) const -> int64_t override
       {
-         return filtered_only ? std::ssize(*m_current_view) : std::ssize(m_data);
+         return filtered_only ? std::ssize(*m_current_view) : std::ssize(*m_data);
+      }
+
+      /// @brief Replace this dataset's records with the records from a newer version of the same table, in-place
+      ///
+      /// @return summary of the changes, or std::nullopt if the records couldn't be matched, in which case
+      ///         neither dataset is modified.
+      auto applyUpdate(IDataset& updated_data, NullableInt tracked_row) -> std::optional<DatasetUpdateResult> override
+      {
+         auto* other = dynamic_cast<CtDataset*>(&updated_data);
+         if (other == nullptr or other == this)
+            return std::nullopt;
+
+         // both datasets may be views of the same (cached) table, in which case nothing changed.
+         if (other->m_data == m_data)
+         {
+            other->releaseData();
+            return DatasetUpdateResult{ .tracked_row = tracked_row and *tracked_row < rowCount(true) ? tracked_row : NullableInt{} };
+         }
+
+         auto delta = detail::diffTables(*m_data, *other->m_data);
+         if (!delta)
+            return std::nullopt;
+
+         // merging sorts and filters records from the new table, so it needs the same computed fields we do.
+         materializeActiveProps(*other->m_data);
+
+         const Record* tracked_rec = nullptr;
+         if (tracked_row and *tracked_row >= 0 and *tracked_row < rowCount(true))
+         {
+            tracked_rec = (*m_current_view)[static_cast<size_t>(*tracked_row)];
+         }
+
+         // Inserted and updated records need to be sorted (updates may have changed a sort key). Everything else 
+         // keeps its position, so we only sort the changed records and merge them into the existing order.
+         const auto& new_data = *other->m_data;
+         std::vector<bool> changed(new_data.size(), false);
+         for (auto idx : delta->inserted) { changed[idx] = true; }
+         for (auto idx : delta->updated)  { changed[idx] = true; }
+
+         auto changed_recs = vws::iota(size_t{}, new_data.size()) | vws::filter([&changed](size_t idx) { return changed[idx]; })
+                                                                  | vws::transform([&new_data](size_t idx) { return &new_data[idx]; })
+                                                                  | rng::to<RecordView>();
+         rng::sort(changed_recs, [this](const Record* rec1, const Record* rec2) { return recordLess(rec1, rec2); });
+
+         auto mergeView = [&](const RecordView& view, const RecordView& added) -> RecordView
+            {
+               // point unchanged records at their copies in the new table, dropping deleted and changed ones.
+               auto kept = view | vws::transform([&](const Record* rec) -> const Record*
+                                    {
+                                       auto idx = delta->old_to_new[m_data->indexOf(rec)];
+                                       return (idx == detail::TableDelta::NoMatch or changed[idx]) ? nullptr : &new_data[idx];
+                                    })
+                                | vws::filter([](const Record* rec) { return rec != nullptr; });
+
+               RecordView merged{};
+               merged.reserve(view.size() + added.size());
+               rng::merge(kept, added, std::back_inserter(merged), [this](const Record* rec1, const Record* rec2) { return recordLess(rec1, rec2); });
+               return merged;
+            };
+
+         auto sorted_view = mergeView(m_sorted_view, changed_recs);
+         auto filtered_view = RecordView{};
+         if (isDataFiltered())
+         {
+            auto added = changed_recs | vws::filter([this](const Record* rec) { return matchesFilters(rec) and matchesSubStringFilter(rec); })
+                                      | rng::to<RecordView>();
+            filtered_view = mergeView(m_filtered_view, added);
+         }
+
+         auto tracked_id = tracked_rec ? delta->old_to_new[m_data->indexOf(tracked_rec)] : detail::TableDelta::NoMatch;
+
+         // our new views point into the other dataset's table, so take ownership of it. The old table 
+         // is released when we return (unless it's shared with another dataset).
+         auto old_data = std::exchange(m_data, other->m_data);
+         m_sorted_view.swap(sorted_view);
+         m_filtered_view.swap(filtered_view);
+         viewChanged();
+         other->releaseData();
+
+         DatasetUpdateResult result{ delta->inserted.size(), delta->updated.size(), delta->deleted.size() };
+         if (tracked_id != detail::TableDelta::NoMatch)
+         {
+            result.tracked_row = rowIndexOf(tracked_id);
+         }
+         return result;
       }
 
       void freezeData() noexcept override
@@ -382,22 +623,29 @@ namespace ctb
    private:
       using ListColumns          = std::vector<ListColumn>;
       using MaybeSubStringFilter = std::optional<SubStringFilter>;
+      using RecordView           = std::vector<const Record*>;
+      using ViewRows             = std::vector<int32_t>;
+
+      static constexpr int32_t ViewRowNone = -1;
 
       bool                 m_frozen{ false };        // If true, data will not requery when filter/sort options are changed, until unfreezeData() is called.
-      DataTable            m_data{};                 // the underlying data records for this table.
-      DataTable            m_filtered_data{};        // we need a copy for the filtered data, so we can bind our views to it
-      DataTable*           m_current_view{};         // may point to m_data or m_filtered_data depending if filter is active or not
+      DataTablePtr         m_data{};                 // the underlying data records for this table, which are never modified and may be shared with other datasets.
+      RecordView           m_sorted_view{};          // all records in m_data, in current sort order
+      RecordView           m_filtered_view{};        // records from m_sorted_view that match the active filters
+      RecordView*          m_current_view{};         // may point to m_sorted_view or m_filtered_view depending if filter is active or not
       ListColumns          m_list_columns{};         // columns that will be displayed in the dataset list-view
       MultiValueFilterMgr  m_mval_filters{};         // active multi-match filters
       PropertyFilterMgr    m_prop_filters{};         // active property filters
       MaybeSubStringFilter m_substring_filter{};
       std::string          m_collection_name{};
       TableSort            m_current_sort{};
+      mutable ViewRows     m_view_rows{};            // row index in m_current_view for each record in m_data (or ViewRowNone), built by rowIndexOf() and cleared when the view changes.
       
       // private construction, use static factory method create();
-      explicit CtDataset(DataTable&& data) : 
+      explicit CtDataset(DataTablePtr data) : 
          m_data{ std::move(data) },
-         m_current_view{ &m_data },
+         m_sorted_view{ std::from_range, *m_data | vws::transform([](const Record& rec) { return &rec; }) },
+         m_current_view{ &m_sorted_view },
          m_list_columns{ std::from_range, Traits::DefaultListColumns },
          m_collection_name{ getTableDescription(getTableId()) },
          m_current_sort{ availableSorts()[0] }
@@ -409,7 +657,23 @@ namespace ctb
 
       auto isDataFiltered() const -> bool 
       { 
-         return m_current_view == &m_filtered_data; 
+         return m_current_view == &m_filtered_view; 
+      }
+
+      /// @brief leaves this dataset empty, after applyUpdate() has taken its records
+      void releaseData()
+      {
+         m_data = std::make_shared<const DataTable>();
+         m_sorted_view.clear();
+         m_filtered_view.clear();
+         m_current_view = &m_sorted_view;
+         viewChanged();
+      }
+
+      /// @brief must be called whenever the records or order of the current view change, so rowIndexOf() doesn't use stale positions
+      void viewChanged() noexcept
+      {
+         m_view_rows.clear();
       }
 
       void applyFilters()
@@ -417,22 +681,19 @@ namespace ctb
          if (m_frozen)
             return;
 
+         materializeActiveProps(*m_data);
+
          if (m_mval_filters.empty() and m_prop_filters.empty())
          {
-            m_current_view = &m_data;
+            m_current_view = &m_sorted_view;
          }
          else{
-            // filters work with property maps, not records (since tables themselves are type-erased), 
-            // so we have to transform back/forth to apply the filters, which is fortunately pretty inexpensive
-            // since we're copying records into m_filtered_data anyways. Since our filter mgrs can be fairly
-            // expensive to copy, use std::ref
-            m_filtered_data = vws::all(m_data) | vws::transform([](auto&& rec) { return rec.getProperties(); }) 
-                                               | vws::filter(std::ref(m_mval_filters))
-                                               | vws::filter(std::ref(m_prop_filters))
-                                               | vws::transform([](auto&& map) { return Record{ map }; })       // back to record
-                                               | rng::to<std::vector>();
-            m_current_view = &m_filtered_data;
+            // The filtered view only holds pointers, records are never copied out of m_data.
+            m_filtered_view = m_sorted_view | vws::filter([this](const Record* rec) { return matchesFilters(rec); }) 
+                                            | rng::to<std::vector>();
+            m_current_view = &m_filtered_view;
          }
+         viewChanged();
 
          if (m_substring_filter)
          {
@@ -440,6 +701,52 @@ namespace ctb
          }
       }
 
+      /// @brief generates any computed fields used by the current sort and filters, for the specified table
+      void materializeActiveProps(const DataTable& data) const
+      {
+         data.materialize(m_current_sort.sort_props);
+         for (const auto& filter : vws::values(m_mval_filters.activeFilters()))
+         {
+            data.materialize(filter.prop_id);
+         }
+         for (const auto& filter : vws::values(m_prop_filters.activeFilters()))
+         {
+            data.materialize(filter.prop_ids);
+         }
+         if (m_substring_filter)
+         {
+            data.materialize(m_substring_filter->search_props);
+         }
+      }
+
+      auto matchesFilters(const Record* rec) const -> bool
+      {
+         // filters work with property maps, not records (since tables themselves are type-erased), 
+         // so we pass each record's property map to the filter managers. 
+         const auto& props = rec->getProperties();
+         return m_mval_filters(props) and m_prop_filters(props);
+      }
+
+      auto matchesSubStringFilter(const Record* rec) const -> bool
+      {
+         return !m_substring_filter or (*m_substring_filter)(*rec);
+      }
+
+      /// @brief creates a substring filter for the specified column, or all list columns if prop_id is empty
+      auto makeSubStringFilter(std::string_view substr, std::optional<CtProp> prop_id) const -> SubStringFilter
+      {
+         if (prop_id)
+         {
+            return SubStringFilter{ std::string{ substr }, std::vector{ *prop_id } };
+         }
+
+         // search all columns in the current list view, so get the prop_id's 
+         auto cols = listColumns() | vws::transform([](const CtListColumn& disp_col) -> auto { return disp_col.prop_id; })
+                                   | rng::to<std::vector>();
+
+         return SubStringFilter{ std::string{ substr }, std::move(cols) };
+      }
+
       bool applySubStringFilter(const SubStringFilter& search_filter)
       {
          // clear any existing substring filter first, since we can only have one at a time. The 
@@ -448,33 +755,50 @@ namespace ctb
          // in the toolbar, which would be confusing).
          m_substring_filter = {};
          applyFilters();
-         auto filtered = vws::all(*m_current_view) | vws::filter(search_filter)
-                                                   | vws::transform([] (auto&& rec) { return static_cast<const Record&>(rec); } )
+         return narrowBySubString(search_filter);
+      }
+
+      /// @brief applies a substring filter to the current view, which must not already have one applied
+      /// 
+      /// @return true if the filter was applied, false if nothing matched (in which case the view is unchanged)
+      bool narrowBySubString(const SubStringFilter& search_filter)
+      {
+         m_data->materialize(search_filter.search_props);
+         auto filtered = vws::all(*m_current_view) | vws::filter([&search_filter](const Record* rec) { return search_filter(*rec); })
                                                    | rng::to<std::vector>();
          if (filtered.empty())
             return false;
 
          m_substring_filter = search_filter;
-         m_filtered_data.swap(filtered);
-         m_current_view = &m_filtered_data;
+         m_filtered_view.swap(filtered);
+         m_current_view = &m_filtered_view;
+         viewChanged();
          return true;
       }
       
-      void sortData()
+      /// @brief compares records using the current sort
+      auto recordLess(const Record* rec1, const Record* rec2) const -> bool
       {
          // the fact that our TableSorter class deals with PropertyMaps is a problem, because we actually need to 
-         // sort a vector<Recordc>. But that would make a table-neutral CtTableSort impossible. So we have to use an 
+         // sort a vector<const Record*>. But that would make a table-neutral CtTableSort impossible. So we have to use an 
          // adapter to allow us to use the sorter object.
-         auto sort_adapter = [this](const Record& rec1, const Record& rec2) -> bool
-            {
-               return m_current_sort(rec1.getProperties(), rec2.getProperties());
-            };
+         return m_current_sort(rec1->getProperties(), rec2->getProperties());
+      }
 
-         // sort the data table, then re-apply any filters to the view. Otherwise we'd have to sort twice
-         rng::sort(m_data, sort_adapter);
+      void sortData()
+      {
+         // sort the view, then re-apply any filters to it. Otherwise we'd have to sort twice
+         sortRecords();
          applyFilters();
       }
 
+      void sortRecords()
+      {
+         m_data->materialize(m_current_sort.sort_props);
+         rng::sort(m_sorted_view, [this](const Record* rec1, const Record* rec2) { return recordLess(rec1, rec2); });
+         viewChanged();
+      }
+
       /// @brief Apply a left-fold to the values for the specified prop_id
       /// 
       /// Note that ValT should be a type that can be used to call CtPropertyVal::as<ValT>()
@@ -503,15 +827,17 @@ namespace ctb
 
       [[nodiscard]] auto getSeriesFiltered(CtProp prop_id) const
       {
-         return vws::transform(*m_current_view, [prop_id](const Record& row) -> const CtPropertyVal&
+         m_data->materialize(prop_id);
+         return vws::transform(*m_current_view, [prop_id](const Record* row) -> const CtPropertyVal&
                                                 { 
-                                                   return row[prop_id]; 
+                                                   return (*row)[prop_id]; 
                                                 });
       }
 
       [[nodiscard]] auto getSeriesRaw(CtProp prop_id) const 
       {
-         return vws::transform(m_data, [prop_id](const Record& row) -> const CtPropertyVal&
+         m_data->materialize(prop_id);
+         return vws::transform(*m_data, [prop_id](const Record& row) -> const CtPropertyVal&
                                        { 
                                           return row[prop_id]; 
                                        });
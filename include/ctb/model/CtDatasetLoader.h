@@ -8,10 +8,15 @@
 #pragma once
 
 #include "ctb/table_data.h"
+#include "ctb/table_download.h"
+#include "ctb/table_sync.h"
 #include "ctb/interfaces/IDataset.h"
+#include "ctb/tasks/TaskExecutor.h"
 
 #include <filesystem>
 #include <memory>
+#include <span>
+#include <stop_token>
 #include <unordered_map>
 
 
@@ -22,6 +27,11 @@ namespace ctb
 
    /// @brief class to load dataset files from disk.
    ///
+   /// Loaded tables are kept in a small LRU cache shared by all loader instances, keyed by the table
+   /// file's path. A cached table is reused as long as the file's size and modification time haven't 
+   /// changed, so re-opening a table is nearly free. Each call returns a new dataset with its own sort 
+   /// and filters, the cached table data itself is immutable and shared between datasets.
+   ///
    class CtDatasetLoader
    {
    public:
@@ -52,11 +62,41 @@ namespace ctb
          return m_data_folder;
       }
 
-      /// @brief Get the requested dataset
+      /// @brief Get the requested dataset, from the table cache if the file hasn't changed since it was cached.
+      ///
+      /// If the table is already being loaded (e.g. by preloadTables()), this waits for that load to finish 
+      /// rather than parsing the file a second time.
       ///
       /// @throws ctb::Error if the dataset couldn't be loaded.
       auto getDataset(TableId tbl) -> DatasetPtr;
 
+      /// @brief Parse any available tables that aren't already cached, on the executor's worker threads.
+      ///
+      /// Tables are loaded into the shared table cache at background priority, so a later getDataset() for
+      /// one of them returns immediately. Loads that haven't started are skipped if stop is requested on 
+      /// token or the executor is shut down. Load errors are logged and otherwise ignored, since the table 
+      /// will just be loaded (and the error reported) on demand instead.
+      /// 
+      /// At most threadCount() - 1 tables are loaded at once (one if the executor only has one thread), so 
+      /// there's always a worker free for interactive tasks, since a running parse can't be preempted.
+      /// 
+      /// @return the number of tables queued for loading
+      /// @throws ctb::Error if the executor has been shut down.
+      auto preloadTables(tasks::TaskExecutor& executor, std::stop_token token = {}) -> size_t;
+
+      /// @brief Download tables from CT, saving them to the data folder and parsing them as they arrive.
+      ///
+      /// This works like ctb::downloadTables(), except that each table that changed is also parsed while it 
+      /// downloads and replaces any cached version, so a following getDataset() doesn't need to read it 
+      /// back from disk. A table that fails to parse is reported as a failed download.
+      /// 
+      /// @return a result for each requested table, in the same order as tables
+      auto downloadTables(const CredentialWrapper& cred, std::span<const TableId> tables, std::stop_token token = {}, 
+                          ProgressCallback* callback = nullptr) -> TableSyncResults;
+
+      /// @brief discard all cached tables, so that subsequent calls to getDataset() will reload from disk
+      static void clearCache();
+
    private:
       fs::path m_data_folder{constants::CURRENT_DIRECTORY};
    };
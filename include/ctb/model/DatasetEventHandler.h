@@ -129,6 +129,11 @@ namespace ctb
       CallbackMap           m_callbacks{};
       EventCallback         m_default_callback{}; // do-nothing default
 
+      auto wantsEvent(EventId event_id) const noexcept -> bool override
+      {
+         return m_default_callback or m_callbacks.contains(event_id);
+      }
+
       void notify(DatasetEvent event) override
       {
          auto it = m_callbacks.find(event.event_id);
@@ -10,8 +10,10 @@
 #include "ctb/ctb.h"
 #include "ctb/interfaces/IDatasetEventSource.h"
 
+#include <functional>
 #include <memory>
 #include <unordered_set>
+#include <vector>
 
 
 namespace ctb
@@ -26,16 +28,71 @@ namespace ctb
    /// only be accessed from the main thread. If communication with background threads is
    /// needed, manual synchronization or a different implementation will be necessary.
    /// 
-   class DatasetEventSource : public IDatasetEventSource
+   /// By default events are dispatched synchronously from signal(). A source created with a 
+   /// DeferFunc instead queues events and dispatches them later in a single flush, which lets 
+   /// a burst of identical events (e.g. several Filter signals from one user action) reach each 
+   /// observer only once. Queued events are dispatched in a fixed order (see dispatchRank()) so 
+   /// that observers see data changes before the selection changes that depend on them.
+   /// DatasetRemove and DatasetInitialize are never deferred, and discard any queued events 
+   /// since those would refer to the old dataset.
+   /// 
+   /// In either mode, observers whose wantsEvent() returns false for an event are skipped.
+   /// 
+   class DatasetEventSource : public IDatasetEventSource, public std::enable_shared_from_this<DatasetEventSource>
    {
    public:
-      /// @brief static method to create a class instance.
+      /// @brief callback used to schedule a deferred flush, typically by posting it to the UI event loop.
+      using DeferFunc = std::function<void(std::function<void()>)>;
+
+      /// @brief static method to create a class instance that dispatches events synchronously.
       ///
       /// note that while you can attach/detach from this object immediately, 
       /// getDataset() will return nullptr and the object won't fire any events 
       /// until a valid table ptr is passed to setDataset().
       [[nodiscard]] static auto create() -> DatasetEventSourcePtr;
 
+      /// @brief static method to create a class instance that coalesces events.
+      ///
+      /// The first event queued after a flush calls defer() with a callback that flushes the queue, 
+      /// so all events signaled before that callback runs are coalesced into a single dispatch.
+      /// 
+      /// @throws ctb::Error if defer is empty
+      [[nodiscard]] static auto create(DeferFunc defer) -> DatasetEventSourcePtr;
+
+      /// @brief returns the relative dispatch order for coalesced events, lower values are dispatched first
+      static constexpr auto dispatchRank(DatasetEvent::Id event_id) noexcept -> int
+      {
+         switch (event_id)
+         {
+            case DatasetEvent::Id::DatasetRemove:      return 0;
+            case DatasetEvent::Id::DatasetInitialize:  return 1;
+            case DatasetEvent::Id::DataUpdate:         return 2;
+            case DatasetEvent::Id::Filter:             return 3;
+            case DatasetEvent::Id::SubStringFilter:    return 4;
+            case DatasetEvent::Id::Sort:               return 5;
+            case DatasetEvent::Id::RowSelected:        return 6;
+         }
+         return 7;
+      }
+
+      /// @brief returns true if this source defers and coalesces events, false if it dispatches them synchronously
+      auto isCoalescing() const noexcept -> bool
+      {
+         return static_cast<bool>(m_defer);
+      }
+
+      /// @brief returns true if there are queued events waiting to be dispatched
+      auto hasPendingEvents() const noexcept -> bool
+      {
+         return !m_pending.empty();
+      }
+
+      /// @brief dispatch any queued events immediately rather than waiting for the deferred flush.
+      ///
+      /// @return true if every observer was notified without error, false if at least one
+      ///  observer threw an error.
+      auto flush() noexcept -> bool;
+
       /// @brief returns true if this source has a table attached, false otherwise
       auto hasDataset() const noexcept -> bool override;
 
@@ -83,6 +140,9 @@ namespace ctb
 
       /// @brief this is called to signal that an event needs to be sent to all observers
       /// 
+      /// If this source is coalescing, the event may be queued rather than dispatched, in which 
+      /// case the return value is always true.
+      /// 
       /// @return true if every observer was notified without error, false if at least one
       ///  observer threw an error.
       auto signal(DatasetEvent::Id event_id) noexcept -> bool override;
@@ -115,12 +175,29 @@ namespace ctb
       ~DatasetEventSource() noexcept override;
 
    private:
-      DatasetPtr m_data{};
+      /// @brief an event waiting to be dispatched by flush()
+      struct PendingEvent
+      {
+         DatasetEvent::Id   event_id{};
+         NullableInt        rec_idx{};
+         IDatasetEventSink* event_source{};
+      };
+
+      DatasetPtr                             m_data{};
       std::unordered_set<IDatasetEventSink*> m_observers{};
-   
+      DeferFunc                              m_defer{};
+      std::vector<PendingEvent>              m_pending{};
+      bool                                   m_flush_scheduled{ false };
+
       /// @brief default ctor is private, use static create()
       DatasetEventSource() = default;
 
+      /// @brief queue an event for the next flush, merging it with any queued event of the same type and source
+      auto enqueue(DatasetEvent::Id event_id, NullableInt rec_idx, IDatasetEventSink* event_source) noexcept -> bool;
+
+      /// @brief send an event to every interested observer except event_source
+      auto dispatch(DatasetEvent::Id event_id, NullableInt rec_idx, IDatasetEventSink* event_source) noexcept -> bool;
+
       // no copy/move/assign, this class is created on the heap and passed around in shared_ptr
       DatasetEventSource(const DatasetEventSource&) = delete;
       DatasetEventSource(DatasetEventSource&&) = delete;
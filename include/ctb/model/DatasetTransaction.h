@@ -0,0 +1,225 @@
+/*******************************************************************
+ * @file DatasetTransaction.h
+ *
+ * @brief Header file for the DatasetTransaction class
+ *
+ * @copyright Copyright © 2025 Jeff Kohn. All rights reserved.
+ *******************************************************************/
+#pragma once
+
+#include "ctb/ctb.h"
+#include "ctb/interfaces/IDataset.h"
+#include "ctb/interfaces/IDatasetEventSource.h"
+
+#include <cassert>
+#include <optional>
+#include <string>
+#include <string_view>
+
+
+namespace ctb
+{
+   /// @brief Collects a batch of sort/filter changes for a dataset and applies them in a single pass.
+   ///
+   /// Changing filters through the dataset's filter managers refreshes the dataset on every call, so
+   /// making several changes that way does redundant work. Changes made through this class are staged
+   /// and not visible in the dataset until commit() is called, at which point the dataset is only
+   /// re-sorted/re-filtered once, and at most one event is signaled per kind of change (sort/filter).
+   ///
+   /// Filter changes are staged against a copy of the dataset's active filters taken when the first
+   /// change of that type is made. Uncommitted changes are discarded when this object is destroyed.
+   ///
+   class DatasetTransaction final
+   {
+   public:
+      using MultiValueFilter  = CtMultiValueFilter;
+      using PropertyFilter    = CtPropertyFilter;
+      using TableSort         = CtTableSort;
+
+      /// @brief construct a transaction for the specified dataset
+      /// @throws ctb::Error if dataset is nullptr
+      explicit DatasetTransaction(DatasetPtr dataset) : m_dataset{ std::move(dataset) }
+      {
+         if (!m_dataset)
+         {
+            assert("dataset cannot be nullptr" and false);
+            throw Error{ Error::Category::ArgumentError, constants::ERROR_STR_NULLPTR_ARG };
+         }
+      }
+
+      /// @brief stage a new sort for the dataset
+      auto setSort(TableSort sort) -> DatasetTransaction&
+      {
+         m_changes.sort = std::move(sort);
+         return *this;
+      }
+
+      /// @brief stage replacing all multi-value filters with the supplied filters, keyed by prop_id
+      template<rng::input_range Rng>
+      auto assignMultiValueFilters(Rng&& filters) -> DatasetTransaction&
+      {
+         auto& staged = m_changes.multival_filters.emplace();
+         for (auto&& filter : filters)
+         {
+            staged.try_emplace(filter.prop_id, std::forward<decltype(filter)>(filter));
+         }
+         return *this;
+      }
+
+      /// @brief stage adding or replacing a multi-value filter
+      auto replaceMultiValueFilter(MultiValueFilter filter) -> DatasetTransaction&
+      {
+         auto prop_id = filter.prop_id;
+         stagedMultiValueFilters()[prop_id] = std::move(filter);
+         return *this;
+      }
+
+      /// @brief stage removing the multi-value filter for the specified property, if there is one
+      auto removeMultiValueFilter(CtProp prop_id) -> DatasetTransaction&
+      {
+         stagedMultiValueFilters().erase(prop_id);
+         return *this;
+      }
+
+      /// @brief stage removing all multi-value filters
+      auto clearMultiValueFilters() -> DatasetTransaction&
+      {
+         m_changes.multival_filters.emplace();
+         return *this;
+      }
+
+      /// @brief stage replacing all property filters with the supplied filters, keyed by filter_name
+      template<rng::input_range Rng>
+      auto assignPropertyFilters(Rng&& filters) -> DatasetTransaction&
+      {
+         auto& staged = m_changes.prop_filters.emplace();
+         for (auto&& filter : filters)
+         {
+            staged.try_emplace(filter.filter_name, std::forward<decltype(filter)>(filter));
+         }
+         return *this;
+      }
+
+      /// @brief stage adding or replacing a property filter
+      auto replacePropertyFilter(PropertyFilter filter) -> DatasetTransaction&
+      {
+         auto name = filter.filter_name;
+         stagedPropertyFilters()[std::move(name)] = std::move(filter);
+         return *this;
+      }
+
+      /// @brief stage removing the named property filter, if there is one
+      auto removePropertyFilter(std::string_view filter_name) -> DatasetTransaction&
+      {
+         auto& staged = stagedPropertyFilters();
+         if (auto it = staged.find(filter_name); it != staged.end())
+         {
+            staged.erase(it);
+         }
+         return *this;
+      }
+
+      /// @brief stage removing all property filters
+      auto clearPropertyFilters() -> DatasetTransaction&
+      {
+         m_changes.prop_filters.emplace();
+         return *this;
+      }
+
+      /// @brief stage a substring filter on the specified column, or on all list columns if prop_id is empty
+      auto filterBySubstring(std::string_view substr, std::optional<CtProp> prop_id = std::nullopt) -> DatasetTransaction&
+      {
+         m_changes.substring_filter = std::string{ substr };
+         m_changes.substring_prop = prop_id;
+         return *this;
+      }
+
+      /// @brief stage clearing the substring filter
+      auto clearSubStringFilter() -> DatasetTransaction&
+      {
+         m_changes.substring_filter = std::string{};
+         m_changes.substring_prop = std::nullopt;
+         return *this;
+      }
+
+      /// @brief stage removing every filter (multi-value, property and substring)
+      auto clearAllFilters() -> DatasetTransaction&
+      {
+         return clearMultiValueFilters().clearPropertyFilters().clearSubStringFilter();
+      }
+
+      /// @brief returns the changes staged so far
+      auto changes() const noexcept -> const DatasetChanges&
+      {
+         return m_changes;
+      }
+
+      /// @brief apply the staged changes to the dataset without signaling any events
+      ///
+      /// Use this for datasets that aren't attached to an event source yet.
+      auto commit() -> DatasetChangeResult
+      {
+         auto result = m_dataset->applyChanges(m_changes);
+         m_changes = {};
+         return result;
+      }
+
+      /// @brief apply the staged changes to the dataset, then signal the source about what changed
+      ///
+      /// A Sort event is signaled if the sort changed, and a Filter event if any filter changed. A
+      /// SubStringFilter event is only signaled if that was the only filter change, since observers
+      /// already refresh their view for the Filter event.
+      ///
+      /// @param source - the event source to signal, which should be the one the dataset is attached to
+      /// @param event_source - optional observer that should not be notified (e.g. the caller).
+      auto commit(IDatasetEventSource& source, IDatasetEventSink* event_source = nullptr) -> DatasetChangeResult
+      {
+         auto result = commit();
+         if (result.sort_changed)
+         {
+            source.signal(DatasetEvent::Id::Sort, event_source);
+         }
+         if (result.filters_changed)
+         {
+            source.signal(DatasetEvent::Id::Filter, event_source);
+         }
+         else if (result.substring_changed)
+         {
+            source.signal(DatasetEvent::Id::SubStringFilter, event_source);
+         }
+         return result;
+      }
+
+      ~DatasetTransaction() noexcept = default;
+
+      // there's really no good reason to copy or move these objects
+      DatasetTransaction() = delete;
+      DatasetTransaction(const DatasetTransaction&) = delete;
+      DatasetTransaction(DatasetTransaction&&) = delete;
+      DatasetTransaction& operator=(const DatasetTransaction&) = delete;
+      DatasetTransaction& operator=(DatasetTransaction&&) = delete;
+
+   private:
+      DatasetPtr     m_dataset{};
+      DatasetChanges m_changes{};
+
+      auto stagedMultiValueFilters() -> DatasetChanges::MultiValueFilters&
+      {
+         if (!m_changes.multival_filters)
+         {
+            m_changes.multival_filters.emplace(std::from_range, m_dataset->multivalFilters().activeFilters());
+         }
+         return *m_changes.multival_filters;
+      }
+
+      auto stagedPropertyFilters() -> DatasetChanges::PropertyFilters&
+      {
+         if (!m_changes.prop_filters)
+         {
+            m_changes.prop_filters.emplace(std::from_range, m_dataset->propFilters().activeFilters());
+         }
+         return *m_changes.prop_filters;
+      }
+   };
+
+} // namespace ctb
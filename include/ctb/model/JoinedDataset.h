@@ -0,0 +1,317 @@
+/*******************************************************************
+ * @file JoinedDataset.h
+ *
+ * @brief Header file for the JoinedDataset class
+ *
+ * @copyright Copyright © 2025 Jeff Kohn. All rights reserved.
+ *******************************************************************/
+#pragma once
+
+#include "ctb/ctb.h"
+#include "ctb/interfaces/IDataset.h"
+
+#include <cassert>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+
+namespace ctb
+{
+   /// @brief a virtual dataset that joins the records of one dataset to the records of another on iWineId.
+   ///
+   /// Each row of the primary dataset is joined to the first record in the secondary dataset with the same
+   /// iWineId (e.g. a left outer join), so the primary should be the table that can have several rows per
+   /// wine. For example, joining Notes to List shows every tasting note along with the wine's details from
+   /// My Cellar. Secondary records are found with the secondary table's iWineId index, so there's no scanning.
+   ///
+   /// Sorting and filtering are done by the primary dataset, so they only work with the primary's properties.
+   /// Properties that only exist in the secondary dataset can be displayed, searched for with getDistinctValues(),
+   /// and looked up with findWineRecords(), but not sorted or filtered on.
+   ///
+   class JoinedDataset final : public IDataset
+   {
+   public:
+      using ListColumns = std::vector<ListColumn>;
+
+      /// @brief create a dataset joining primary to secondary
+      ///
+      /// @param primary - dataset that determines the rows, sort and filters of the joined dataset
+      /// @param secondary - dataset to look up properties that primary doesn't have
+      /// @param joined_columns - list columns for the secondary's properties, shown after the primary's columns
+      /// @return shared_ptr to the requested object
+      /// @throws ctb::Error if either dataset is nullptr
+      static auto create(DatasetPtr primary, DatasetPtr secondary, ListColumnSpan joined_columns = {}) -> DatasetPtr
+      {
+         if (!primary or !secondary)
+         {
+            assert("dataset cannot be nullptr" and false);
+            throw Error{ Error::Category::ArgumentError, constants::ERROR_STR_NULLPTR_ARG };
+         }
+         return DatasetPtr{ static_cast<IDataset*>(new JoinedDataset{ std::move(primary), std::move(secondary), joined_columns }) };
+      }
+
+      /// @brief returns the primary dataset
+      auto primary() const -> const DatasetPtr&
+      {
+         return m_primary;
+      }
+
+      /// @brief returns the secondary dataset
+      auto secondary() const -> const DatasetPtr&
+      {
+         return m_secondary;
+      }
+
+      auto getTableId() const -> TableId override
+      {
+         return m_primary->getTableId();
+      }
+
+      auto getTableName() const -> std::string_view override
+      {
+         return m_primary->getTableName();
+      }
+
+      auto getCollectionName() const -> const std::string& override
+      {
+         return m_primary->getCollectionName();
+      }
+
+      void setCollectionName(std::string_view name) override
+      {
+         m_primary->setCollectionName(name);
+      }
+
+      auto getDataSummary() const -> std::string override
+      {
+         return m_primary->getDataSummary();
+      }
+
+      /// @brief returns the schema for a property from the primary dataset, or the secondary if primary doesn't have it
+      auto getFieldSchema(Prop prop_id) const -> std::optional<FieldSchema> override
+      {
+         auto schema = m_primary->getFieldSchema(prop_id);
+         return schema ? schema : m_secondary->getFieldSchema(prop_id);
+      }
+
+      /// @brief returns the primary's list columns, followed by the joined columns
+      auto listColumns() const -> ListColumnSpan override
+      {
+         return m_list_columns;
+      }
+
+      /// @return true if either dataset has the property
+      auto hasProperty(Prop prop_id) const -> bool override
+      {
+         return m_primary->hasProperty(prop_id) or m_secondary->hasProperty(prop_id);
+      }
+
+      auto availableSorts() const -> TableSortSpan override
+      {
+         return m_primary->availableSorts();
+      }
+
+      auto availableMultiValueFilters() const -> CtMultiValueFilterSpan override
+      {
+         return m_primary->availableMultiValueFilters();
+      }
+
+      auto activeSort() const -> const TableSort& override
+      {
+         return m_primary->activeSort();
+      }
+
+      void applySort(const TableSort& sort) override
+      {
+         m_primary->applySort(sort);
+      }
+
+      /// @brief Apply a search filter that does substring matching on the primary dataset's list columns
+      auto filterBySubstring(std::string_view substr) -> bool override
+      {
+         return m_primary->filterBySubstring(substr);
+      }
+
+      /// @brief Apply a search filter that does substring matching on the specified column of the primary dataset
+      auto filterBySubstring(std::string_view substr, CtProp prop_id) -> bool override
+      {
+         return m_primary->filterBySubstring(substr, prop_id);
+      }
+
+      void clearSubStringFilter() override
+      {
+         m_primary->clearSubStringFilter();
+      }
+
+      auto propFilters() -> PropertyFilterMgr& override
+      {
+         return m_primary->propFilters();
+      }
+
+      auto propFilters() const -> const PropertyFilterMgr& override
+      {
+         return std::as_const(*m_primary).propFilters();
+      }
+
+      auto multivalFilters() -> MultiValueFilterMgr& override
+      {
+         return m_primary->multivalFilters();
+      }
+
+      auto multivalFilters() const -> const MultiValueFilterMgr& override
+      {
+         return std::as_const(*m_primary).multivalFilters();
+      }
+
+      /// @brief Retrieve a property for a specified record/row in the dataset
+      ///
+      /// Properties the primary dataset doesn't have come from the first matching record in the secondary
+      /// dataset, or a null value if there isn't one.
+      auto getProperty(int rec_idx, CtProp prop_id) const -> const PropertyVal& override
+      {
+         if (m_primary->hasProperty(prop_id))
+            return m_primary->getProperty(rec_idx, prop_id);
+
+         return lookupProperty(m_primary->getProperty(rec_idx, CtProp::iWineId), prop_id);
+      }
+
+      [[nodiscard]] auto getDistinctValues(CtProp prop_id, bool use_current_filters) const -> PropertyValueSet override
+      {
+         if (m_primary->hasProperty(prop_id))
+            return m_primary->getDistinctValues(prop_id, use_current_filters);
+
+         return lookupDistinctValues(m_primary->getDistinctValues(CtProp::iWineId, use_current_filters), prop_id);
+      }
+
+      [[nodiscard]] auto getDistinctValues(CtProp prop_id, std::function<bool(const PropertyMap&)> custom_filter) const -> PropertyValueSet override
+      {
+         if (m_primary->hasProperty(prop_id))
+            return m_primary->getDistinctValues(prop_id, std::move(custom_filter));
+
+         return lookupDistinctValues(m_primary->getDistinctValues(CtProp::iWineId, std::move(custom_filter)), prop_id);
+      }
+
+      /// @brief Find all of the primary dataset's records for a wine
+      auto findWineRecords(uint64_t wine_id, const std::function<void(const PropertyMap&)>& visitor) const -> size_t override
+      {
+         return m_primary->findWineRecords(wine_id, visitor);
+      }
+
+      /// @brief returns the primary dataset's primary key, since it determines the rows
+      auto primaryKey() const -> std::span<const Prop> override
+      {
+         return m_primary->primaryKey();
+      }
+
+      auto getRowId(int rec_idx) const -> RowId override
+      {
+         return m_primary->getRowId(rec_idx);
+      }
+
+      auto findRowId(std::span<const PropertyVal> key) const -> std::optional<RowId> override
+      {
+         return m_primary->findRowId(key);
+      }
+
+      auto rowIndexOf(RowId row_id) const -> NullableInt override
+      {
+         return m_primary->rowIndexOf(row_id);
+      }
+
+      auto rowCount(bool filtered_only) const -> int64_t override
+      {
+         return m_primary->rowCount(filtered_only);
+      }
+
+      void freezeData() override
+      {
+         m_primary->freezeData();
+      }
+
+      void unfreezeData() override
+      {
+         m_primary->unfreezeData();
+      }
+
+      auto applyChanges(const DatasetChanges& changes) -> DatasetChangeResult override
+      {
+         return m_primary->applyChanges(changes);
+      }
+
+      /// @brief Replace this dataset's records with those from another JoinedDataset of the same tables
+      ///
+      /// The primary dataset is updated in-place, the secondary dataset is replaced by the other's secondary.
+      /// @return summary of the primary's changes, or std::nullopt if updated_data isn't a JoinedDataset or
+      ///         its primary couldn't be applied.
+      auto applyUpdate(IDataset& updated_data, NullableInt tracked_row) -> std::optional<DatasetUpdateResult> override
+      {
+         auto* other = dynamic_cast<JoinedDataset*>(&updated_data);
+         if (other == nullptr or other == this)
+            return std::nullopt;
+
+         auto result = m_primary->applyUpdate(*other->m_primary, tracked_row);
+         if (result)
+         {
+            m_secondary = std::move(other->m_secondary);
+         }
+         return result;
+      }
+
+      ~JoinedDataset() noexcept override = default;
+
+      JoinedDataset() = delete;
+      JoinedDataset(const JoinedDataset&) = delete;
+      JoinedDataset(JoinedDataset&&) = delete;
+      JoinedDataset& operator=(const JoinedDataset&) = delete;
+      JoinedDataset& operator=(JoinedDataset&&) = delete;
+
+   private:
+      DatasetPtr  m_primary{};
+      DatasetPtr  m_secondary{};
+      ListColumns m_list_columns{};
+
+      JoinedDataset(DatasetPtr primary, DatasetPtr secondary, ListColumnSpan joined_columns) :
+         m_primary{ std::move(primary) },
+         m_secondary{ std::move(secondary) },
+         m_list_columns{ std::from_range, m_primary->listColumns() }
+      {
+         m_list_columns.append_range(joined_columns);
+      }
+
+      /// @brief returns the value of prop_id from the first secondary record for the wine, or null if there isn't one
+      auto lookupProperty(const PropertyVal& wine_id, CtProp prop_id) const -> const PropertyVal&
+      {
+         const PropertyVal* result = &ct_null_prop;
+
+         auto id = wine_id.asUInt64();
+         if (id and m_secondary->hasProperty(prop_id))
+         {
+            m_secondary->findWineRecords(*id, [&result, prop_id](const PropertyMap& rec)
+               {
+                  if (result != &ct_null_prop)
+                     return;
+
+                  if (auto it = rec.find(prop_id); it != rec.end())
+                     result = &it->second;
+               });
+         }
+         return *result;
+      }
+
+      auto lookupDistinctValues(const PropertyValueSet& wine_ids, CtProp prop_id) const -> PropertyValueSet
+      {
+         PropertyValueSet values{};
+         if (m_secondary->hasProperty(prop_id))
+         {
+            for (const auto& wine_id : wine_ids)
+            {
+               values.emplace(lookupProperty(wine_id, prop_id));
+            }
+         }
+         return values;
+      }
+   };
+
+} // namespace ctb
@@ -0,0 +1,98 @@
+/*******************************************************************
+ * @file WineLookupService.h
+ *
+ * @brief Header file for the WineLookupService class
+ *
+ * @copyright Copyright © 2025 Jeff Kohn. All rights reserved.
+ *******************************************************************/
+#pragma once
+
+#include "ctb/ctb.h"
+#include "ctb/interfaces/IDataset.h"
+#include "ctb/model/CtDatasetLoader.h"
+
+#include <filesystem>
+#include <functional>
+#include <map>
+
+
+namespace ctb
+{
+   namespace fs = std::filesystem;
+
+
+   /// @brief finds the records for a wine across all of the tables in a data folder, and creates joined datasets.
+   ///
+   /// Each table is loaded the first time it's needed (from CtDatasetLoader's cache if possible), and lookups use 
+   /// the table's iWineId index, so finding a wine's records in another table is a hash lookup instead of a scan. 
+   /// If a table's file changes (e.g. after a sync), the next lookup in that table loads the new version.
+   ///
+   /// This class is not thread-safe.
+   ///
+   class WineLookupService final
+   {
+   public:
+      using RecordVisitor = std::function<void(const CtPropertyMap&)>;
+
+      /// @brief construct a service for the tables in the specified data folder
+      /// @throws ctb::Error if the folder doesn't exist
+      explicit WineLookupService(const fs::path& data_folder) noexcept(false) : m_loader{ data_folder }
+      {}
+
+      /// @brief find the records in a table for the specified wine
+      ///
+      /// @param tbl - the table to look in
+      /// @param wine_id - the wine to look for
+      /// @param visitor - called with each matching record's properties, which are valid until the next call to 
+      ///  this object. Can be empty if you only need the count.
+      /// @return the number of matching records. Zero if the table isn't available.
+      /// @throws ctb::Error if the table couldn't be loaded
+      auto findRecords(TableId tbl, uint64_t wine_id, const RecordVisitor& visitor = {}) -> size_t;
+
+      /// @brief count the records for the specified wine in each available table
+      /// @return map of table to record count, tables with no records for the wine are omitted.
+      /// @throws ctb::Error if a table couldn't be loaded
+      auto countRecords(uint64_t wine_id) -> std::map<TableId, size_t>;
+
+      /// @brief create a dataset that joins the records of the primary table with the secondary table on iWineId
+      ///
+      /// The joined dataset gets its own datasets for both tables, so it can be sorted and filtered independently 
+      /// of any other datasets. See JoinedDataset for details.
+      /// 
+      /// @param primary - the table that determines the joined dataset's rows (e.g. Notes)
+      /// @param secondary - the table to look up other properties in (e.g. List)
+      /// @param joined_columns - list columns for properties from the secondary table
+      /// @throws ctb::Error if either table couldn't be loaded
+      auto createJoinedDataset(TableId primary, TableId secondary, CtListColumnSpan joined_columns = {}) -> DatasetPtr;
+
+      /// @brief release all of the datasets held for lookups
+      void clear() noexcept
+      {
+         m_lookup_datasets.clear();
+      }
+
+      ~WineLookupService() noexcept = default;
+
+      WineLookupService() = delete;
+      WineLookupService(const WineLookupService&) = delete;
+      WineLookupService(WineLookupService&&) = default;
+      WineLookupService& operator=(const WineLookupService&) = delete;
+      WineLookupService& operator=(WineLookupService&&) = default;
+
+   private:
+      /// @brief a dataset used for lookups, and the version of the table file it was loaded from
+      struct LookupDataset
+      {
+         DatasetPtr         dataset{};
+         fs::file_time_type last_write{};
+      };
+
+      CtDatasetLoader                    m_loader;
+      std::map<TableId, LookupDataset>   m_lookup_datasets{};
+
+      /// @brief get the dataset to use for lookups in a table, loading it if necessary 
+      /// @return the dataset, or nullptr if the table isn't available
+      auto lookupDataset(TableId tbl) -> DatasetPtr;
+   };
+
+} // namespace ctb
@@ -10,6 +10,8 @@
 #pragma once
 
 #include "ctb/ctb.h"
+#include "ctb/utility.h"
+#include "ctb/tables/detail/CsvSourceReader.h"
 
 #pragma warning(push)
 #pragma warning(disable: 4365 4464 4702)
@@ -21,6 +23,7 @@
 #include <algorithm>
 #include <expected>
 #include <filesystem>
+#include <span>
 
 #include <string>
 #include <string_view>
@@ -152,6 +155,10 @@ namespace ctb
    /// 
    /// Note the lack of a "format" parameter, we currently only support parsing CSV files.
    ///
+   /// If the table's records have lazy fields, the file is read into memory and split in place, so those
+   /// fields don't need to be copied while parsing. Their text is then packed into a single buffer owned 
+   /// by the table, and the rest of the file is released.
+   ///
    template <typename TableDataT>
    auto loadTableData(fs::path data_folder, TableId tbl) -> std::expected<TableDataT, Error>
    {
@@ -159,15 +166,150 @@ namespace ctb
       if (not isTableFileAvailable(table_path))
          return std::unexpected{ Error{ ERROR_FILE_NOT_FOUND, Error::Category::FileError, constants::FMT_ERROR_FILE_NOT_FOUND, table_path.generic_string() } };
 
-      csv::CSVReader reader{ table_path.generic_string() };
-
-      TableDataT data{};
-      for (csv::CSVRow& row : reader)
+      if constexpr (requires { requires TableDataT::Record::HasLazyFields; })
       {
-         data.emplace_back(row);
+         try
+         {
+            auto source = readBinaryFile(table_path, constants::MAX_TABLE_FILE_BYTES);
+            std::span<char> source_text{ reinterpret_cast<char*>(source.data()), source.size() };
+
+            TableDataT data{};
+            detail::CsvSourceReader reader{ source_text };
+
+            // first row is the header
+            detail::CsvSourceRow row{};
+            reader.readRow(row);
+            while (reader.readRow(row))
+            {
+               data.emplace_back(row);
+            }
+            data.retainLazyText(source_text);
+            return data;
+         }
+         catch (...)
+         {
+            return std::unexpected{ packageError() };
+         }
+      }
+      else {
+         csv::CSVReader reader{ table_path.generic_string() };
+
+         TableDataT data{};
+         for (csv::CSVRow& row : reader)
+         {
+            data.emplace_back(row);
+         }
+         return data;
       }
-      return data;
    }
 
 
+   /// @brief class to parse a CSV table incrementally, as its text arrives in arbitrary chunks.
+   ///
+   /// The CSV parser can only read complete, seekable input, so we buffer incoming text until we have
+   /// at least STREAM_PARSE_BATCH_BYTES worth of complete rows, then parse that batch (prefixed with the 
+   /// header row) while the rest of the download is still in flight. A row is only complete once we see a 
+   /// line break outside of a quoted field, since fields like tasting notes can contain embedded newlines.
+   ///
+   /// Batches for tables with lazy fields are split in place like loadTableData() does, and only the lazy 
+   /// fields' text is kept (one buffer per batch), so a downloaded table uses the same memory as one loaded 
+   /// from disk.
+   ///
+   template <typename TableDataT>
+   class IncrementalTableParser
+   {
+   public:
+      /// @brief add a chunk of table text, parsing any complete rows if we have enough of them buffered
+      void feed(std::string_view chunk)
+      {
+         m_pending.append(chunk);
+         scanForRowEnd();
+
+         if (m_rows_end >= constants::STREAM_PARSE_BATCH_BYTES)
+            parseCompleteRows();
+      }
+
+      /// @brief parse whatever text remains and return the table. The parser should not be used afterward.
+      auto finish() -> TableDataT
+      {
+         // whatever is left is the final row, even if it's missing a trailing newline.
+         m_rows_end = m_pending.size();
+         parseCompleteRows();
+         return std::move(m_data);
+      }
+
+   private:
+      TableDataT  m_data{};
+      std::string m_header{};    // header row, including line break. Empty until we've seen the whole thing.
+      std::string m_pending{};   // text that hasn't been parsed yet
+      size_t      m_scanned{};   // offset in m_pending we've scanned for row ends
+      size_t      m_rows_end{};  // offset in m_pending just past the last complete row
+      bool        m_in_quotes{};
+
+      void scanForRowEnd()
+      {
+         for (; m_scanned < m_pending.size(); ++m_scanned)
+         {
+            // escaped quotes ("") toggle twice, so they don't affect the state
+            auto ch = m_pending[m_scanned];
+            if (ch == '"')
+            {
+               m_in_quotes = !m_in_quotes;
+            }
+            else if (ch == '\n' and not m_in_quotes)
+            {
+               m_rows_end = m_scanned + 1;
+               if (m_header.empty())
+               {
+                  m_header = m_pending.substr(0, m_rows_end);
+                  m_pending.erase(0, m_rows_end);
+                  m_scanned = 0;
+                  m_rows_end = 0;
+                  scanForRowEnd();
+                  return;
+               }
+            }
+         }
+      }
+
+      void parseCompleteRows()
+      {
+         if (m_rows_end == 0)
+            return;
+
+         if constexpr (requires { requires TableDataT::Record::HasLazyFields; })
+         {
+            // the header was already split off, and CsvSourceReader doesn't need it
+            auto batch = m_pending.substr(0, m_rows_end);
+            consumeCompleteRows();
+
+            auto first_record = m_data.size();
+            detail::CsvSourceReader reader{ std::span<char>{ batch.data(), batch.size() } };
+            detail::CsvSourceRow row{};
+            while (reader.readRow(row))
+            {
+               m_data.emplace_back(row);
+            }
+            m_data.retainLazyText(batch, first_record);
+         }
+         else {
+            auto batch = m_header + m_pending.substr(0, m_rows_end);
+            consumeCompleteRows();
+
+            for (auto reader = csv::parse(batch, csv::CSVFormat{}); csv::CSVRow& row : reader)
+            {
+               m_data.emplace_back(row);
+            }
+         }
+      }
+
+      void consumeCompleteRows()
+      {
+         m_pending.erase(0, m_rows_end);
+         m_scanned -= std::min(m_scanned, m_rows_end);
+         m_rows_end = 0;
+      }
+   };
+
+
 } // namespace ctb
\ No newline at end of file
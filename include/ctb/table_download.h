@@ -46,11 +46,99 @@ namespace ctb
    /// 
    /// @param convert_to_utf - If true, the downloaded data is assumed will be converted from Windows-1252 to UTF-8.
    ///                          If false, the downloaded data is returned to the caller un-modified and can be converted as needed (or not)
+   /// @param base_url - the URL to request tables from, without query parameters. Only needs to be specified for testing.
    /// 
    /// @return expected/successful value is the requested table data, unexpected/error value is HTTP status code
    [[nodiscard]] auto downloadRawTableData(const CredentialWrapper& cred, TableId table,  DataFormatId format, ProgressCallback* callback = nullptr, 
-                                           bool convert_to_utf = true, uint32_t table_code_page = CP_WINDOWS_1252) -> DownloadResult;
+                                           bool convert_to_utf = true, uint32_t table_code_page = CP_WINDOWS_1252, 
+                                           std::string_view base_url = constants::URL_CT_TABLE) -> DownloadResult;
 
 
+   /// @brief callback functor that receives the body of a download as it arrives. Return false to cancel the download.
+   using DownloadChunkCallback = std::function<bool(std::string_view chunk)>;
 
-} // namespace ctb
\ No newline at end of file
+
+   /// @brief the result of downloading a table to disk. The expected value is true if the file was updated, or false 
+   ///        if the table hasn't changed since the last download and the existing file was left alone.
+   using TableFileResult = std::expected<bool, Error>;
+
+
+   /// @brief Stream a data table from CT website directly to a file on disk
+   /// 
+   /// The response is written to a temporary file as it arrives and only renamed to file_path once the download
+   /// has completed successfully, so an existing file is never replaced with a partial or failed download. Each 
+   /// chunk is also passed to chunk_callback (after conversion to UTF-8 if requested), which allows it to be parsed 
+   /// while the download is still in progress.
+   /// 
+   /// The response's cache validators (ETag/Last-Modified) and a hash of the content are saved next to the file,
+   /// and used to make a conditional request the next time the table is downloaded. If the server reports that the
+   /// table hasn't changed, no data is transferred. If it sends the table anyway but the content is identical to
+   /// what we already have, the existing file is kept.
+   /// 
+   /// @param cred           - the username/password to use for the download
+   /// @param table          - the table to retrieve
+   /// @param format         - the data format to return
+   /// @param file_path      - where to save the table
+   /// @param chunk_callback - optional callback to receive the table text as it's downloaded
+   /// @param callback       - optional callback to receive progress updates
+   /// @param convert_to_utf - If true, the downloaded data is converted from table_code_page to UTF-8 before being saved.
+   /// @param base_url       - the URL to request tables from, without query parameters. Only needs to be specified for testing.
+   /// 
+   /// @return expected value indicates whether the file was updated, unexpected/error value is HTTP status code
+   [[nodiscard]] auto downloadTableFile(const CredentialWrapper& cred, TableId table, DataFormatId format, const fs::path& file_path, 
+                                        DownloadChunkCallback* chunk_callback = nullptr, ProgressCallback* callback = nullptr,
+                                        bool convert_to_utf = true, uint32_t table_code_page = CP_WINDOWS_1252, 
+                                        std::string_view base_url = constants::URL_CT_TABLE) -> TableFileResult;
+
+
+   /// @brief Download a data table from CT website, saving it to file_path and parsing it as it arrives.
+   /// 
+   /// This is equivalent to calling downloadTableFile() and then loadTableData(), except that the table 
+   /// is parsed while the download is in progress and the full response text is never held in memory. 
+   /// 
+   /// @return expected value is the requested table object, or std::nullopt if the table hasn't changed since
+   ///         it was last downloaded (in which case the existing file is left alone). Unexpected value is Error 
+   ///         information if the download or parsing failed.
+   template <typename TableDataT>
+   [[nodiscard]] auto downloadTableData(const CredentialWrapper& cred, TableId table, const fs::path& file_path, ProgressCallback* callback = nullptr,
+                                        uint32_t table_code_page = CP_WINDOWS_1252) -> std::expected<std::optional<TableDataT>, Error>
+   {
+      IncrementalTableParser<TableDataT> parser{};
+      std::optional<Error> parse_error{};
+      DownloadChunkCallback parse_chunk = [&parser, &parse_error](std::string_view chunk) -> bool
+         {
+            // exceptions can't propagate through curl, so abort the download and report the error afterwards
+            try
+            {
+               parser.feed(chunk);
+               return true;
+            }
+            catch (...)
+            {
+               parse_error = packageError();
+               return false;
+            }
+         };
+
+      auto result = downloadTableFile(cred, table, DataFormatId::csv, file_path, &parse_chunk, callback, true, table_code_page);
+      if (parse_error)
+         return std::unexpected{ *parse_error };
+
+      if (!result)
+         return std::unexpected{ result.error() };
+
+      if (not *result)
+         return std::optional<TableDataT>{};
+
+      try
+      {
+         return parser.finish();
+      }
+      catch (...)
+      {
+         return std::unexpected{ packageError() };
+      }
+   }
+
+
+} // namespace ctb
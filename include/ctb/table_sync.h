@@ -0,0 +1,69 @@
+/*******************************************************************
+ * @file table_sync.h
+ *
+ * @brief Header file for functionality in the ctb namespace for
+ *        syncing multiple data tables from CellarTracker.com
+ * 
+ * @copyright Copyright © 2025 Jeff Kohn. All rights reserved. 
+ *
+ *******************************************************************/
+#pragma once
+
+#include "ctb/ctb.h"
+#include "ctb/table_download.h"
+
+#include <functional>
+#include <span>
+#include <stop_token>
+#include <vector>
+
+
+namespace ctb
+{
+
+   /// @brief the result of downloading a single table as part of a sync operation
+   struct TableSyncResult
+   {
+      TableId         table_id{};
+      TableFileResult result{};
+   };
+
+
+   /// @brief results for a sync operation, in the same order as the requested tables
+   using TableSyncResults = std::vector<TableSyncResult>;
+
+
+   /// @brief function that downloads a single table to file_path as part of a sync operation, with the same
+   ///        semantics as downloadTableFile(). This lets the caller do something with each table as it arrives.
+   using TableDownloadFunc = std::function<TableFileResult(const CredentialWrapper& cred, TableId table, DataFormatId format, 
+                                                           const fs::path& file_path, ProgressCallback* callback)>;
+
+
+   /// @brief Download multiple data tables from CT website concurrently, saving them to the data folder
+   /// 
+   /// Downloads run on up to max_concurrent worker threads, all sharing the same credential. Each table is saved
+   /// using download_table if specified, or downloadTableFile() otherwise, so tables that haven't changed since they 
+   /// were last downloaded are skipped. download_table is called on the worker threads. This function blocks 
+   /// until all downloads are complete, but the callback is always called on the calling thread (every 
+   /// SYNC_PROGRESS_INTERVAL_MS), so it's safe to use it to update the UI.
+   /// 
+   /// If the stop_token is signaled or the callback returns false, any downloads in progress are aborted and 
+   /// any that haven't started are skipped, in both cases their result will be an OperationCanceled error. 
+   /// An authentication failure for any table also stops the remaining downloads, since they'd fail too.
+   /// 
+   /// @param cred           - the username/password to use for the downloads
+   /// @param tables         - the tables to retrieve
+   /// @param format         - the data format to return
+   /// @param data_folder    - the folder to save the tables to
+   /// @param stop_token     - optional token that can be used to cancel the operation
+   /// @param callback       - optional callback to receive progress updates for all downloads combined, and allow cancellation
+   /// @param download_table - optional function to download each table, instead of downloadTableFile()
+   /// @param max_concurrent - the maximum number of downloads to run at the same time
+   /// 
+   /// @return a result for each requested table, in the same order as tables
+   [[nodiscard]] auto downloadTables(const CredentialWrapper& cred, std::span<const TableId> tables, DataFormatId format, 
+                                     const fs::path& data_folder, std::stop_token stop_token = {}, ProgressCallback* callback = nullptr, 
+                                     const TableDownloadFunc& download_table = {}, size_t max_concurrent = constants::SYNC_MAX_CONCURRENT_DOWNLOADS) -> TableSyncResults;
+
+
+} // namespace ctb
@@ -21,18 +21,21 @@ namespace ctb
    class ConsumedWineTraits
    {
    public:
-      using Prop             = CtProp;
-      using PropertyVal      = CtPropertyVal;
-      using PropType         = detail::PropType;
-      using PropertyMap      = CtPropertyMap;
-      using FieldSchema      = CtFieldSchema;
-      using ListColumn       = CtListColumn;
-      using ListColumnSpan   = CtListColumnSpan;
-      using MultiValueFilter = detail::MultiValueFilter<Prop, PropertyMap>;
-      using TableSort        = detail::TableSorter<CtProp, CtPropertyMap>;
+      using Prop               = CtProp;
+      using PropertyVal        = CtPropertyVal;
+      using PropType           = detail::PropType;
+      using PropertyMap        = CtPropertyMap;
+      using MutablePropertyMap = CtMutablePropertyMap;
+      using FieldSchema        = CtFieldSchema;
+      using ListColumn         = CtListColumn;
+      using ListColumnSpan     = CtListColumnSpan;
+      using MultiValueFilter   = detail::MultiValueFilter<Prop, PropertyMap>;
+      using TableSort          = detail::TableSorter<CtProp, CtPropertyMap>;
+      using ComputedField      = CtComputedField;
 
       static inline constexpr auto Schema = frozen::make_map<Prop, FieldSchema>(
       {
+         { Prop::WineAndVintage,  FieldSchema { Prop::WineAndVintage, PropType::String,   {} }},
          { Prop::iWineId,         FieldSchema { Prop::iWineId,        PropType::UInt64,    1 }},
          { Prop::WineName,        FieldSchema { Prop::WineName,       PropType::String,   33 }},
          { Prop::Locale,          FieldSchema { Prop::Locale,         PropType::String,   35 }},
@@ -52,14 +55,24 @@ namespace ctb
          { Prop::ConsumeYear,     FieldSchema { Prop::ConsumeYear,    PropType::UInt16,   {} }},
          { Prop::ConsumeMonth,    FieldSchema { Prop::ConsumeMonth,   PropType::String,   {} }},
          { Prop::ConsumeReason,   FieldSchema { Prop::ConsumeReason,  PropType::String,   11 }},
-         { Prop::ConsumeNote,     FieldSchema { Prop::ConsumeNote,    PropType::String,   27 }},
-         { Prop::PurchaseNote,    FieldSchema { Prop::PurchaseNote,   PropType::String,   28 }},
-         { Prop::BottleNote,      FieldSchema { Prop::BottleNote,     PropType::String,   29 }},
+         { Prop::ConsumeNote,     FieldSchema { Prop::ConsumeNote,    PropType::String,   27, FieldSchema::Lazy }},
+         { Prop::PurchaseNote,    FieldSchema { Prop::PurchaseNote,   PropType::String,   28, FieldSchema::Lazy }},
+         { Prop::BottleNote,      FieldSchema { Prop::BottleNote,     PropType::String,   29, FieldSchema::Lazy }},
          { Prop::Location,        FieldSchema { Prop::Location,       PropType::String,   30 }},
          { Prop::Bin,             FieldSchema { Prop::Bin,            PropType::String,   31 }},
          { Prop::Size,            FieldSchema { Prop::Size,           PropType::String,    9 }},
       });
 
+      /// @brief the properties that uniquely identify a record in this table
+      static inline constexpr std::array PrimaryKey{ Prop::iConsumeId };
+
+      /// @brief properties that are generated from other properties, the first time they're needed
+      static inline constexpr std::array ComputedFields
+      {
+         ComputedField{ Prop::WineAndVintage, &detail::getWineAndVintage },
+         ComputedField{ Prop::ConsumeMonth,   &detail::getConsumeMonth },
+      };
+
       /// @brief list of display columns that will show in the list view
       static inline const std::array DefaultListColumns
       {
@@ -113,19 +126,17 @@ namespace ctb
 
       /// @brief this gets called by TableRecord to set any missing property values
       /// 
-      /// PropertyMap values from the CSV file are already set, this impl just provides
-      /// any calculated property values or does fixup for any parsed values that need it.
+      /// PropertyMap values from the CSV file are already set, this impl just does fixup
+      /// for any parsed values that need it. Calculated values are declared in ComputedFields.
       /// 
       /// @param rec - a map containing a property value for each field the table supports
-      static void onRecordParse(PropertyMap& rec)
+      static void onRecordParse(MutablePropertyMap& rec)
       {
          using enum Prop;
 
-         rec[WineAndVintage] = getWineAndVintage(rec);
          if (auto consume_date = rec[ConsumeDate].asDate(); consume_date)
          {
             rec[ConsumeYear] = static_cast<uint16_t>(static_cast<int>(consume_date->year())); // this is lame
-            rec[ConsumeMonth] = ctb::format("{:%B}", *consume_date);
          }
       }
 
@@ -1,16 +1,19 @@
 #pragma once
 
 #include "ctb/ctb.h"
+#include "ctb/tables/detail/CompactPropertyValue.h"
+#include "ctb/tables/detail/ComputedField.h"
+#include "ctb/tables/detail/DataTable.h"
 #include "ctb/tables/detail/FieldSchema.h"
 #include "ctb/tables/detail/FilterManager.h"
 #include "ctb/tables/detail/ListColumn.h"
 #include "ctb/tables/detail/MultiValueFilter.h"
 #include "ctb/tables/detail/PropertyFilter.h"
+#include "ctb/tables/detail/PropertySlots.h"
 #include "ctb/tables/detail/PropertyValue.h"
 #include "ctb/tables/detail/TableRecord.h"
 #include "ctb/tables/detail/TableSorter.h"
 
-#include <boost/unordered/unordered_flat_map.hpp>
 #include <chrono>
 
 
@@ -128,7 +131,9 @@ namespace ctb
   
    
    /// @brief Type alias for the property type used in CellarTracker data tables
-   using CtPropertyVal = detail::PropertyValue<std::string, uint16_t, uint64_t, double, std::chrono::year_month_day, bool>;
+   ///
+   /// values are 16 bytes, with long strings stored in their table's arena (see CompactPropertyValue)
+   using CtPropertyVal = detail::CompactPropertyValue;
 
    
    /// @brief Type alias for a sorted collection of property values
@@ -140,7 +145,18 @@ namespace ctb
 
 
    /// @brief Type alias for a table record indexed on a property enum instead of zero-based index
-   using CtPropertyMap = boost::unordered_flat_map<CtProp, CtPropertyVal>; 
+   ///
+   /// this is a read-only map-like view over a record's fixed slot storage, which lets table-neutral code 
+   /// like filters and sorters work with records from any table.
+   using CtPropertyMap = detail::ConstSlottedPropertyMap<CtProp, CtPropertyVal>; 
+
+
+   /// @brief Type alias for a writable view of a record's properties, which is only used while the record is being parsed
+   using CtMutablePropertyMap = detail::SlottedPropertyMap<CtProp, CtPropertyVal>;
+
+
+   /// @brief Type alias for a CtProp-based computed field, whose value is generated on demand
+   using CtComputedField = detail::ComputedField<CtProp, CtPropertyMap>;
 
 
    /// @brief Type alias for a CtProp-based record in a CellarTracker data table
@@ -158,7 +174,7 @@ namespace ctb
 
    /// @brief Type alias for a CtProp-based data table of CellarTracker records
    template <RecordTraitsType RecordTraits>
-   using CtDataTable = std::vector<CtTableRecord<RecordTraits> >;
+   using CtDataTable = detail::DataTable<CtTableRecord<RecordTraits> >;
 
 
    /// @brief Type alias for CtProp-based multi-match filter
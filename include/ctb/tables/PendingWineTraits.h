@@ -23,15 +23,17 @@ namespace ctb
    class PendingWineTraits
    {
    public:
-      using Prop             = CtProp;
-      using PropertyVal      = CtPropertyVal;
-      using PropType         = detail::PropType;
-      using PropertyMap      = CtPropertyMap;
-      using FieldSchema      = CtFieldSchema;
-      using ListColumn       = CtListColumn;
-      using ListColumnSpan   = CtListColumnSpan;
-      using MultiValueFilter = detail::MultiValueFilter<Prop, PropertyMap>;
-      using TableSort        = detail::TableSorter<CtProp, CtPropertyMap>;
+      using Prop               = CtProp;
+      using PropertyVal        = CtPropertyVal;
+      using PropType           = detail::PropType;
+      using PropertyMap        = CtPropertyMap;
+      using MutablePropertyMap = CtMutablePropertyMap;
+      using FieldSchema        = CtFieldSchema;
+      using ListColumn         = CtListColumn;
+      using ListColumnSpan     = CtListColumnSpan;
+      using MultiValueFilter   = detail::MultiValueFilter<Prop, PropertyMap>;
+      using TableSort          = detail::TableSorter<CtProp, CtPropertyMap>;
+      using ComputedField      = CtComputedField;
 
       static inline constexpr auto Schema = frozen::make_map<Prop, FieldSchema>(
       {
@@ -60,6 +62,17 @@ namespace ctb
          { Prop::WineAndVintage,         FieldSchema { Prop::WineAndVintage,        PropType::String,     {} }},
       });
 
+      /// @brief the properties that uniquely identify a record in this table
+      ///
+      /// Note that a pending order can include more than one wine, so the purchase id alone isn't unique.
+      static inline constexpr std::array PrimaryKey{ Prop::PendingPurchaseId, Prop::iWineId };
+
+      /// @brief properties that are generated from other properties, the first time they're needed
+      static inline constexpr std::array ComputedFields
+      {
+         ComputedField{ Prop::WineAndVintage, &detail::getWineAndVintage },
+      };
+
       /// @brief list of display columns that will show in the list view
       static inline const std::array DefaultListColumns
       { 
@@ -118,11 +131,11 @@ namespace ctb
 
       /// @brief this gets called by TableRecord to set any missing property values
       /// 
-      /// PropertyMap values from the CSV file are already set, this impl just provides
-      /// any calculated property values or does fixup for any parsed values that need it.
+      /// PropertyMap values from the CSV file are already set, this impl just does fixup
+      /// for any parsed values that need it. Calculated values are declared in ComputedFields.
       /// 
       /// @param rec - a map containing a property value for each field the table supports
-      static void onRecordParse(PropertyMap& rec)
+      static void onRecordParse(MutablePropertyMap& rec)
       {
          using enum Prop;
 
@@ -132,7 +145,6 @@ namespace ctb
          {
             rec[PendingDeliveryDate] = ct_null_prop;
          }
-         rec[WineAndVintage] =getWineAndVintage(rec);
       }
       
    };
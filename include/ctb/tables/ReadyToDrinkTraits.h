@@ -28,11 +28,13 @@ namespace ctb
       using PropertyVal          = CtPropertyVal;
       using PropType             = detail::PropType;
       using PropertyMap          = CtPropertyMap;
+      using MutablePropertyMap   = CtMutablePropertyMap;
       using FieldSchema          = detail::FieldSchema<Prop>;
       using ListColumn           = CtListColumn;
       using ListColumnSpan       = CtListColumnSpan;
       using MultiValueFilter     = detail::MultiValueFilter<Prop, PropertyMap>;
       using TableSort            = detail::TableSorter<CtProp, CtPropertyMap>;
+      using ComputedField        = CtComputedField;
 
       static inline constexpr auto Schema = frozen::make_map<Prop, FieldSchema>(
       {
@@ -77,6 +79,17 @@ namespace ctb
 
       static inline constexpr int TWO_DECIMAL_PLACES{ 2 };
 
+      /// @brief the properties that uniquely identify a record in this table
+      static inline constexpr std::array PrimaryKey{ Prop::iWineId };
+
+      /// @brief properties that are generated from other properties, the first time they're needed
+      static inline constexpr std::array ComputedFields
+      {
+         ComputedField{ Prop::WineAndVintage,      &detail::getWineAndVintage },
+         ComputedField{ Prop::QtyTotal,            &detail::calcQtyTotal },
+         ComputedField{ Prop::RtdInventorySummary, &detail::getRtdInventory },
+      };
+
       /// @brief list of display columns that will show in the list view
       static inline const std::array DefaultListColumns 
       { 
@@ -140,18 +153,14 @@ namespace ctb
 
       /// @brief this gets called by TableRecord to set any missing property values
       /// 
-      /// PropertyMap from the CSV file are already set, this impl just provides
-      /// any calculated property values or does fixup for any parsed values that need it.
+      /// PropertyMap from the CSV file are already set, this impl just does fixup
+      /// for any parsed values that need it. Calculated values are declared in ComputedFields.
       /// 
       /// @param rec - map containing a PropertyValue for each PropID enum value.
-      static void onRecordParse(PropertyMap& rec)
+      static void onRecordParse(MutablePropertyMap& rec)
       {
          using enum Prop;
 
-         rec[WineAndVintage]      = getWineAndVintage(rec);
-         rec[QtyTotal]            = calcQtyTotal(rec);
-         rec[RtdInventorySummary] = getRtdInventory(rec);
-
          auto qty_logical  = rec[RtdInventoryLogical].asUInt16().value_or(0);
          auto qty_physical = rec[RtdInventoryPhysical].asUInt16().value_or(qty_logical); // so we default to 750ml
 
@@ -17,18 +17,20 @@ namespace ctb
       using PropertyVal = CtPropertyVal;
       using PropType = detail::PropType;
       using PropertyMap = CtPropertyMap;
+      using MutablePropertyMap = CtMutablePropertyMap;
       using FieldSchema = detail::FieldSchema<Prop>;
       using ListColumn = CtListColumn;
       using ListColumnSpan = CtListColumnSpan;
       using MultiValueFilter = detail::MultiValueFilter<Prop, PropertyMap>;
       using TableSort = detail::TableSorter<CtProp, CtPropertyMap>;
+      using ComputedField = CtComputedField;
 
       static inline constexpr auto Schema = frozen::make_map<Prop, FieldSchema>(
          {
             { Prop::iWineId,         FieldSchema { Prop::iWineId,        PropType::UInt64,     11 }},
             { Prop::WineName,        FieldSchema { Prop::WineName,       PropType::String,      8 }},
             { Prop::TagName,         FieldSchema { Prop::TagName,        PropType::String,      0 }},
-            { Prop::TagWineNote,     FieldSchema { Prop::TagWineNote,   PropType::String,      3 }},
+            { Prop::TagWineNote,     FieldSchema { Prop::TagWineNote,   PropType::String,      3, FieldSchema::Lazy }},
             { Prop::TagMaxPrice,     FieldSchema { Prop::TagMaxPrice,    PropType::Double,      4 }},
             { Prop::Vintage,         FieldSchema { Prop::Vintage,        PropType::UInt16,      7 }},
             { Prop::Locale,          FieldSchema { Prop::Locale,         PropType::String,      9 }},
@@ -44,6 +46,17 @@ namespace ctb
             { Prop::WineAndVintage,  FieldSchema { Prop::WineAndVintage, PropType::String,     {} }},
          });
 
+      /// @brief the properties that uniquely identify a record in this table
+      ///
+      /// Note that a wine can have more than one tag, so iWineId alone isn't unique.
+      static inline constexpr std::array PrimaryKey{ Prop::TagName, Prop::iWineId };
+
+      /// @brief properties that are generated from other properties, the first time they're needed
+      static inline constexpr std::array ComputedFields
+      {
+         ComputedField{ Prop::WineAndVintage, &detail::getWineAndVintage },
+      };
+
       /// @brief list of display columns that will show in the list view
       static inline const std::array DefaultListColumns
       {
@@ -100,15 +113,13 @@ namespace ctb
 
       /// @brief this gets called by TableRecord to set any missing property values
       /// 
-      /// PropertyMap from the CSV file are already set, this impl just provides
-      /// any calculated property values or does fixup for any parsed values that need it.
+      /// PropertyMap from the CSV file are already set, this impl just does fixup
+      /// for any parsed values that need it. Calculated values are declared in ComputedFields.
       /// 
       /// @param rec - map containing a PropertyValue for each PropID enum value.
-      static void onRecordParse(PropertyMap& rec)
+      static void onRecordParse([[maybe_unused]] MutablePropertyMap& rec)
       {
-         using enum Prop;
-
-         rec[WineAndVintage] = getWineAndVintage(rec);
+         // nothing to fix up, WineAndVintage is a computed field.
       }
    };
 
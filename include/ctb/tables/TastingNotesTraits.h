@@ -22,15 +22,17 @@ namespace ctb
    class TastingNotesTraits
    {
    public:
-      using Prop             = CtProp;
-      using PropertyVal      = CtPropertyVal;
-      using PropType         = detail::PropType;
-      using PropertyMap      = CtPropertyMap;
-      using FieldSchema      = CtFieldSchema;
-      using ListColumn       = CtListColumn;
-      using ListColumnSpan   = CtListColumnSpan;
-      using MultiValueFilter = detail::MultiValueFilter<Prop, PropertyMap>;
-      using TableSort        = detail::TableSorter<CtProp, CtPropertyMap>;
+      using Prop               = CtProp;
+      using PropertyVal        = CtPropertyVal;
+      using PropType           = detail::PropType;
+      using PropertyMap        = CtPropertyMap;
+      using MutablePropertyMap = CtMutablePropertyMap;
+      using FieldSchema        = CtFieldSchema;
+      using ListColumn         = CtListColumn;
+      using ListColumnSpan     = CtListColumnSpan;
+      using MultiValueFilter   = detail::MultiValueFilter<Prop, PropertyMap>;
+      using TableSort          = detail::TableSorter<CtProp, CtPropertyMap>;
+      using ComputedField      = CtComputedField;
 
       static inline constexpr auto Schema = frozen::make_map<Prop, FieldSchema>(
       {
@@ -52,7 +54,7 @@ namespace ctb
          { Prop::TastingDate,           FieldSchema { Prop::TastingDate,          PropType::Date,       18 }},
          { Prop::TastingFlawed,         FieldSchema { Prop::TastingFlawed,        PropType::Boolean,    19 }},
          { Prop::TastingLiked,          FieldSchema { Prop::TastingLiked,         PropType::Boolean,    32 }},
-         { Prop::TastingNotes,          FieldSchema { Prop::TastingNotes,         PropType::String,     31 }},
+         { Prop::TastingNotes,          FieldSchema { Prop::TastingNotes,         PropType::String,     31, FieldSchema::Lazy }},
          { Prop::TastingCommentCount,   FieldSchema { Prop::TastingCommentCount,  PropType::UInt16,     38 }},
          { Prop::TastingViewCount,      FieldSchema { Prop::TastingViewCount,     PropType::UInt16,     21 }},
          { Prop::TastingVoteCount,      FieldSchema { Prop::TastingVoteCount,     PropType::UInt16,     37 }},
@@ -62,6 +64,15 @@ namespace ctb
          { Prop::WineAndVintage,        FieldSchema { Prop::WineAndVintage,       PropType::String,     {} }},
       });
 
+      /// @brief the properties that uniquely identify a record in this table
+      static inline constexpr std::array PrimaryKey{ Prop::iTastingNoteId };
+
+      /// @brief properties that are generated from other properties, the first time they're needed
+      static inline constexpr std::array ComputedFields
+      {
+         ComputedField{ Prop::WineAndVintage, &detail::getWineAndVintage },
+      };
+
       /// @brief list of display columns that will show in the list view
       static inline const std::array DefaultListColumns 
       { 
@@ -120,16 +131,14 @@ namespace ctb
 
       /// @brief this gets called by TableRecord to set any missing property values
       /// 
-      /// PropertyMap values from the CSV file are already set, this impl just provides
-      /// any calculated property values or does fixup for any parsed values that need it.
+      /// PropertyMap values from the CSV file are already set, this impl just does fixup
+      /// for any parsed values that need it. Calculated values are declared in ComputedFields.
       /// 
       /// @param rec - a map containing a property value for each field the table supports
-      static void onRecordParse(PropertyMap& rec)
+      static void onRecordParse(MutablePropertyMap& rec)
       {
          using enum Prop;
 
-         rec[WineAndVintage] = getWineAndVintage(rec);
-         
          auto score = rec[MyScore].asInt32().value_or(0);
          if (score == 0)
          {
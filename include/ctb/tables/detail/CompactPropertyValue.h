@@ -0,0 +1,587 @@
+/*******************************************************************
+* @file  CompactPropertyValue.h
+*
+* @brief defines the class CompactPropertyValue
+*
+* @copyright Copyright © 2025 Jeff Kohn. All rights reserved.
+*******************************************************************/
+#pragma once
+
+#include "ctb/ctb.h"
+#include "ctb/utility.h"
+#include "ctb/utility_chrono.h"
+#include "ctb/utility_templates.h"
+
+#include <array>
+#include <chrono>
+#include <compare>
+#include <cstring>
+#include <functional>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+
+
+
+namespace ctb::detail
+{
+
+   /// @brief 16-byte tagged value type for properties in a table record.
+   ///
+   /// This class has the same public interface as PropertyValue (and the same conversion and comparison
+   /// semantics), but instead of a std::variant it packs the value into 15 bytes of payload plus a 1-byte
+   /// type tag. Strings that fit in the payload are stored inline. Longer strings are stored as a pointer
+   /// and length, either to a copy owned by this object or to text owned by a table (its string arena, or
+   /// the text of its lazy fields).
+   ///
+   /// Values that reference a table's arena are only views. Copying one produces a value that owns its
+   /// string, so copies are always safe to hold onto. Moving one does not, since that's how records get
+   /// moved around within their table, so you should only move values between objects owned by the same
+   /// table.
+   ///
+   /// Default-constructed instances of this object will always have a 'null' value.
+   ///
+   class CompactPropertyValue
+   {
+   public:
+      using ValueType = std::variant<std::monostate, std::string, uint16_t, uint64_t, double, std::chrono::year_month_day, bool>;
+
+      /// @brief maximum length of a string that can be stored inline.
+      static constexpr size_t InlineCapacity = 14;
+
+      /// @brief Create a CompactPropertyValue from a string_view by converting it to the specified type.
+      ///
+      /// @return A CompactPropertyValue containing the converted value if the conversion succeeds, or a
+      ///  null CompactPropertyValue otherwise.
+		template<ArithmeticType ValT> requires std::convertible_to<ValT, ValueType>
+      [[nodiscard]] static auto parse(std::string_view text_value) -> CompactPropertyValue
+      {
+         auto val = from_str<ValT>(text_value);
+         return val ? CompactPropertyValue{ *val } : CompactPropertyValue{};
+      }
+
+      /// @brief Create a CompactPropertyValue from a string_view by parsing it as a year_month_day
+      /// @return a CompactPropertyValue containing the parsed date, or a null value if the string couldn't parsed
+      template<typename ValT> requires std::same_as<std::chrono::year_month_day, ValT>
+      [[nodiscard]] static auto parse(std::string_view date_str) -> CompactPropertyValue
+      {
+         auto parse_result = parseDate(date_str, constants::FMT_PARSE_DATE_SHORT);
+         return parse_result.has_value() ? CompactPropertyValue{ *parse_result } : CompactPropertyValue{};
+      }
+
+      /// @brief Create a CompactPropertyValue from a string_view by parsing it as a bool
+      /// @return a CompactPropertyValue containing the parsed bool, or a null value if the string couldn't parsed
+		template<BooleanType ValT>
+      [[nodiscard]] static auto parse(std::string_view bool_str) -> CompactPropertyValue
+      {
+         auto val = textToBool(bool_str);
+         return val.has_value() ? CompactPropertyValue{ *val } : CompactPropertyValue{};
+      }
+
+      /// @brief construct a CompactPropertyValue from any value convertible to ValueType
+      ///
+      /// this is intentionally non-explicit, because callers won't always have the exact
+      /// typename easily available.
+      template<std::convertible_to<ValueType> T>
+      CompactPropertyValue(T&& val)
+      {
+         assign(ValueType{ std::forward<T>(val) });
+      }
+
+      /// @brief construct a string value, storing it in the supplied arena if it's too long to store inline.
+      ///
+      /// the arena must outlive this object and any object it's moved to.
+      CompactPropertyValue(std::string_view str, std::pmr::memory_resource* arena)
+      {
+         if (str.size() <= InlineCapacity)
+         {
+            setInlineString(str);
+         }
+         else {
+            auto* buf = static_cast<char*>(arena->allocate(str.size(), alignof(char)));
+            std::memcpy(buf, str.data(), str.size());
+            setExternalString(buf, str.size(), Kind::ArenaString);
+         }
+      }
+
+      /// @brief construct a string value that references str in place if it's too long to store inline.
+      ///
+      /// this is used for lazy fields, which reference text kept by their table. str must
+      /// outlive this object and any object it's moved to, same as a string stored in an arena.
+      [[nodiscard]] static auto makeView(std::string_view str) noexcept -> CompactPropertyValue
+      {
+         CompactPropertyValue val{};
+         if (str.size() <= InlineCapacity)
+         {
+            val.setInlineString(str);
+         }
+         else {
+            val.setExternalString(str.data(), str.size(), Kind::ArenaString);
+         }
+         return val;
+      }
+
+      /// @return whether or not this object contains a 'null' value.
+      auto isNull() const -> bool
+      {
+         return m_kind == Kind::Null;
+      }
+
+      /// @return Returns true if isNull() == false
+      auto hasValue() const -> bool
+      {
+         return !isNull();
+      }
+
+      /// @brief sets the contained value of this object to represent 'null'
+      ///
+      void setNull()
+      {
+         release();
+      }
+
+      /// @brief if this object owns a heap-allocated string, move it into the supplied arena.
+      ///
+      /// this is used for calculated string values that are assigned to records after parsing. The
+      /// arena must outlive this object and any object it's moved to.
+      void relocateString(std::pmr::memory_resource* arena)
+      {
+         if (m_kind == Kind::HeapString)
+         {
+            *this = CompactPropertyValue{ asStringView(), arena };
+         }
+      }
+
+      /// @brief Get a numeric value out of the property
+      ///
+      /// If the property contains a string, parsing will be attempted. For anything else, the result
+      /// will be a static_cast to T if possible, or std::nullopt if not.
+      ///
+      /// @returns an optional containing the result if successful, std::nullopt if not.
+      template<ArithmeticType T>
+      auto as() const -> std::optional<T>
+      {
+         switch (m_kind)
+         {
+            case Kind::InlineString: [[fallthrough]];
+            case Kind::ArenaString:  [[fallthrough]];
+            case Kind::HeapString:   return from_str<T>(asStringView());
+            case Kind::UInt16:       return static_cast<T>(load<uint16_t>());
+            case Kind::UInt64:       return static_cast<T>(load<uint64_t>());
+            case Kind::Double:       return static_cast<T>(load<double>());
+            case Kind::Boolean:      return static_cast<T>(load<bool>());
+            case Kind::Date:         [[fallthrough]]; // no conversion that makes sense
+            case Kind::Null:         [[fallthrough]];
+            default:                 return std::nullopt;
+         }
+      }
+
+      /// @brief Extract date value from the property object, if possible
+      ///
+      /// The object must contain a year_month_date, or a string that can be parsed as a date.
+      /// All other data types will result in empty return value.
+      ///
+      /// @return A valid year_month_date, or std::nullopt if the value is not compatible
+      auto asDate() const -> NullableDate
+      {
+         NullableDate result{};
+         if (m_kind == Kind::Date)
+         {
+            result = loadDate();
+         }
+         else if (hasString())
+         {
+            if (auto parse_result = parseDate(asStringView(), constants::FMT_PARSE_DATE_SHORT); parse_result.has_value())
+            {
+               result = *parse_result;
+            }
+         }
+         return result;
+      }
+
+      /// @brief get a string value out of the property
+      ///
+      /// @return the requested value, or an empty string if no value is available (e.g. null)
+      auto asString() const -> std::string
+      {
+         if (hasString())
+         {
+            return std::string{ asStringView() };
+         }
+         return asString(constants::FMT_DEFAULT_FORMAT);
+      }
+
+      /// @brief get a formatted string value out of the property.
+      /// @param fmt_str format string to use for formatting the value. Must contain exactly 1 {} placeholder
+      /// @return the requested value, or an empty string if isNull().
+      ///
+      /// Note that if the property isNull(), the fmt_str will not be used - you will always get an empty string
+      ///
+      auto asString(std::string_view fmt_str) const -> std::string
+      {
+         using namespace constants;
+
+         switch (m_kind)
+         {
+            case Kind::InlineString: [[fallthrough]];
+            case Kind::ArenaString:  [[fallthrough]];
+            case Kind::HeapString:
+            {
+               auto str = asStringView();
+               return ctb::vformat(fmt_str, ctb::make_format_args(str));
+            }
+            case Kind::UInt16:
+            {
+               auto val = load<uint16_t>();
+               return ctb::vformat(fmt_str, ctb::make_format_args(val));
+            }
+            case Kind::UInt64:
+            {
+               auto val = load<uint64_t>();
+               return ctb::vformat(fmt_str, ctb::make_format_args(val));
+            }
+            case Kind::Double:
+            {
+               auto val = load<double>();
+               return ctb::vformat(fmt_str, ctb::make_format_args(val));
+            }
+            case Kind::Date:
+            {
+               auto val = loadDate();
+               return ctb::vformat(fmt_str == FMT_DEFAULT_FORMAT ? FMT_DATE_SHORT : fmt_str, ctb::make_format_args(val));
+            }
+            case Kind::Boolean:
+               return load<bool>() ? std::string{ STR_YES } : std::string{ STR_NO };
+
+            case Kind::Null: [[fallthrough]];
+            default:
+               return std::string{};
+         }
+      }
+
+      /// @brief return string_view to the internal string property
+      /// @return the requested string_view, or an empty one if this property doesn't contain a string.
+      ///
+      /// this method does not convert other types to string_view, because that would require a view on a temporary.
+      /// if the contained property is not a valid string, you'll get an empty string_view back.
+      auto asStringView() const -> std::string_view
+      {
+         switch (m_kind)
+         {
+            case Kind::InlineString:
+               return std::string_view{ m_data.data(), static_cast<size_t>(m_data[InlineCapacity]) };
+
+            case Kind::ArenaString: [[fallthrough]];
+            case Kind::HeapString:
+               return std::string_view{ load<const char*>(), load<uint32_t>(LengthOffset) };
+
+            default:
+               return {};
+         }
+      }
+
+      /// @brief indicates whether this property contains a string
+      /// @return true if the property type is string, false if it's anything else
+      ///
+      /// this can be useful in determining whether you want to call asString() or asStringView()
+      /// since the former will convert numbers to string and the latter will not.
+      ///
+      auto hasString() const -> bool
+      {
+         return m_kind == Kind::InlineString or m_kind == Kind::ArenaString or m_kind == Kind::HeapString;
+      }
+
+      /// @brief convenience function getting value as int32_t
+      auto asInt32() const -> NullableInt
+      {
+         return as<int32_t>();
+      }
+
+      /// @brief convenience function getting value as uint16_t
+      auto asUInt16() const -> NullableShort
+      {
+         return as<uint16_t>();
+      }
+
+      /// @brief convenience function getting value as uint64_t
+      auto asUInt64() const -> NullableSize_t
+      {
+         return as<uint64_t>();
+      }
+
+      /// @brief convenience function getting value as double
+      auto asDouble() const -> NullableDouble
+      {
+         return as<double>();
+      }
+
+		/// Returns property as boolean. Incompatible types will always be false (date/time, etc)
+      auto asBool() const -> NullableBool
+      {
+         switch (m_kind)
+         {
+            case Kind::Null:    return std::nullopt;
+            case Kind::Date:    return false;
+            case Kind::UInt16:  return static_cast<bool>(load<uint16_t>());
+            case Kind::UInt64:  return static_cast<bool>(load<uint64_t>());
+            case Kind::Double:  return static_cast<bool>(load<double>());
+            case Kind::Boolean: return load<bool>();
+            default:            return textToBool(asStringView());
+         }
+      }
+
+      /// @brief Returns a copy of the value as a std::variant, so that it can be visited.
+      ///
+      /// unlike PropertyValue, this isn't a reference to the internal representation because
+      /// there is no variant stored in this object.
+      auto variant() const -> ValueType
+      {
+         switch (m_kind)
+         {
+            case Kind::InlineString: [[fallthrough]];
+            case Kind::ArenaString:  [[fallthrough]];
+            case Kind::HeapString:   return std::string{ asStringView() };
+            case Kind::UInt16:       return load<uint16_t>();
+            case Kind::UInt64:       return load<uint64_t>();
+            case Kind::Double:       return load<double>();
+            case Kind::Date:         return loadDate();
+            case Kind::Boolean:      return load<bool>();
+            default:                 return std::monostate{};
+         }
+      }
+
+      /// @brief allows for comparison of CompactPropertyValue objects, as well as putting them in ordered containers
+      ///
+      /// ordering is the same as comparing the equivalent ValueType variants.
+      [[nodiscard]] auto operator<=>(const CompactPropertyValue& other) const -> std::partial_ordering
+      {
+         auto idx = variantIndex();
+         if (auto cmp = idx <=> other.variantIndex(); cmp != 0)
+            return cmp;
+
+         switch (m_kind)
+         {
+            case Kind::UInt16:  return load<uint16_t>() <=> other.load<uint16_t>();
+            case Kind::UInt64:  return load<uint64_t>() <=> other.load<uint64_t>();
+            case Kind::Double:  return load<double>()   <=> other.load<double>();
+            case Kind::Date:    return loadDate()       <=> other.loadDate();
+            case Kind::Boolean: return load<bool>()     <=> other.load<bool>();
+            case Kind::Null:    return std::partial_ordering::equivalent;
+            default:            return asStringView()   <=> other.asStringView();
+         }
+      }
+
+      auto operator==(const CompactPropertyValue& other) const -> bool
+      {
+         return std::is_eq(*this <=> other);
+      }
+
+      /// @brief returns a hash of the value, so that it can be used as (part of) a key in unordered containers
+      ///
+      /// values that compare equal have the same hash, regardless of how their strings are stored.
+      auto hash() const noexcept -> size_t
+      {
+         size_t val_hash{};
+         switch (m_kind)
+         {
+            case Kind::UInt16:  val_hash = std::hash<uint16_t>{}(load<uint16_t>());   break;
+            case Kind::UInt64:  val_hash = std::hash<uint64_t>{}(load<uint64_t>());   break;
+            case Kind::Double:  val_hash = std::hash<double>{}(load<double>());       break;
+            case Kind::Date:    val_hash = std::hash<int64_t>{}(std::chrono::sys_days{ loadDate() }.time_since_epoch().count()); break;
+            case Kind::Boolean: val_hash = std::hash<bool>{}(load<bool>());           break;
+            case Kind::Null:    break;
+            default:            val_hash = std::hash<std::string_view>{}(asStringView()); break;
+         }
+         return val_hash ^ (variantIndex() * 0x9E3779B97F4A7C15ull);
+      }
+
+      /// @brief allow assigning values, not just CompactPropertyValues
+      template<typename Self, std::convertible_to<ValueType> T>
+      auto&& operator=(this Self&& self, T&& t)
+      {
+         self = CompactPropertyValue{ std::forward<T>(t) };
+         return std::forward<Self>(self);
+      }
+
+      constexpr CompactPropertyValue() noexcept = default;
+
+      constexpr ~CompactPropertyValue() noexcept
+      {
+         if (m_kind == Kind::HeapString)
+            release();
+      }
+
+      CompactPropertyValue(const CompactPropertyValue& other)
+      {
+         copyFrom(other);
+      }
+
+      CompactPropertyValue(CompactPropertyValue&& other) noexcept
+      {
+         takeFrom(other);
+      }
+
+      CompactPropertyValue& operator=(const CompactPropertyValue& other)
+      {
+         if (this != &other)
+         {
+            release();
+            copyFrom(other);
+         }
+         return *this;
+      }
+
+      CompactPropertyValue& operator=(CompactPropertyValue&& other) noexcept
+      {
+         if (this != &other)
+         {
+            release();
+            takeFrom(other);
+         }
+         return *this;
+      }
+
+   private:
+      /// @brief the type of value stored in the payload.
+      enum class Kind : uint8_t
+      {
+         Null,
+         InlineString,
+         ArenaString,
+         HeapString,
+         UInt16,
+         UInt64,
+         Double,
+         Date,
+         Boolean
+      };
+
+      // external strings store a pointer at offset 0 and the length at LengthOffset. Inline strings store
+      // their length in the last byte of the payload.
+      static constexpr size_t PayloadSize  = InlineCapacity + 1;
+      static constexpr size_t LengthOffset = sizeof(const char*);
+
+      alignas(8) std::array<char, PayloadSize> m_data{};
+      Kind m_kind{ Kind::Null };
+
+      template<typename T>
+      auto load(size_t offset = 0) const noexcept -> T
+      {
+         T val{};
+         std::memcpy(&val, m_data.data() + offset, sizeof(T));
+         return val;
+      }
+
+      template<typename T>
+      void store(T val, size_t offset = 0) noexcept
+      {
+         std::memcpy(m_data.data() + offset, &val, sizeof(T));
+      }
+
+      auto loadDate() const noexcept -> std::chrono::year_month_day
+      {
+         using namespace std::chrono;
+         return year_month_day{ year{ load<int16_t>() }, month{ load<uint8_t>(2) }, day{ load<uint8_t>(3) } };
+      }
+
+      void storeDate(const std::chrono::year_month_day& ymd) noexcept
+      {
+         store(static_cast<int16_t>(static_cast<int>(ymd.year())));
+         store(static_cast<uint8_t>(static_cast<unsigned>(ymd.month())), 2);
+         store(static_cast<uint8_t>(static_cast<unsigned>(ymd.day())), 3);
+      }
+
+      void setInlineString(std::string_view str) noexcept
+      {
+         std::memcpy(m_data.data(), str.data(), str.size());
+         m_data[InlineCapacity] = static_cast<char>(str.size());
+         m_kind = Kind::InlineString;
+      }
+
+      void setExternalString(const char* str, size_t len, Kind kind) noexcept
+      {
+         store(str);
+         store(static_cast<uint32_t>(len), LengthOffset);
+         m_kind = kind;
+      }
+
+      void setHeapString(std::string_view str)
+      {
+         if (str.size() <= InlineCapacity)
+         {
+            setInlineString(str);
+         }
+         else {
+            auto* buf = new char[str.size()];
+            std::memcpy(buf, str.data(), str.size());
+            setExternalString(buf, str.size(), Kind::HeapString);
+         }
+      }
+
+      /// @brief index of the equivalent ValueType alternative, used for ordering
+      auto variantIndex() const noexcept -> size_t
+      {
+         switch (m_kind)
+         {
+            case Kind::InlineString: [[fallthrough]];
+            case Kind::ArenaString:  [[fallthrough]];
+            case Kind::HeapString:   return 1;
+            case Kind::UInt16:       return 2;
+            case Kind::UInt64:       return 3;
+            case Kind::Double:       return 4;
+            case Kind::Date:         return 5;
+            case Kind::Boolean:      return 6;
+            default:                 return 0;
+         }
+      }
+
+      void assign(ValueType&& val)
+      {
+         auto assignVal = Overloaded
+         {
+            [this](std::monostate)                           { m_kind = Kind::Null;                   },
+            [this](const std::string& str)                   { setHeapString(str);                    },
+            [this](uint16_t val)                             { store(val); m_kind = Kind::UInt16;     },
+            [this](uint64_t val)                             { store(val); m_kind = Kind::UInt64;     },
+            [this](double val)                               { store(val); m_kind = Kind::Double;     },
+            [this](const std::chrono::year_month_day& ymd)   { storeDate(ymd); m_kind = Kind::Date;   },
+            [this](bool val)                                 { store(val); m_kind = Kind::Boolean;    },
+         };
+         std::visit(assignVal, val);
+      }
+
+      void copyFrom(const CompactPropertyValue& other)
+      {
+         if (other.m_kind == Kind::ArenaString or other.m_kind == Kind::HeapString)
+         {
+            setHeapString(other.asStringView());
+         }
+         else {
+            m_data = other.m_data;
+            m_kind = other.m_kind;
+         }
+      }
+
+      void takeFrom(CompactPropertyValue& other) noexcept
+      {
+         m_data = other.m_data;
+         m_kind = other.m_kind;
+         other.m_kind = Kind::Null;
+      }
+
+      void release() noexcept
+      {
+         if (m_kind == Kind::HeapString)
+         {
+            delete[] load<const char*>();
+         }
+         m_kind = Kind::Null;
+      }
+   };
+
+   static_assert(sizeof(CompactPropertyValue) == 16);
+
+
+}  // namespace ctb::detail
@@ -0,0 +1,38 @@
+/*******************************************************************
+ * @file ComputedField.h
+ *
+ * @brief defines the template struct ComputedField
+ *
+ * @copyright Copyright © 2025 Jeff Kohn. All rights reserved.
+ *******************************************************************/
+#pragma once
+
+#include "ctb/ctb.h"
+
+
+namespace ctb::detail
+{
+
+   /// @brief declares a property whose value is generated from a record's other properties, rather than
+   ///        being parsed from the CSV.
+   ///
+   /// Traits classes list these in their ComputedFields array. Values for records owned by a DataTable are
+   /// only generated when the table's materialize() is called for the property, which happens the first time
+   /// a dataset needs it (to display, sort, filter, etc). Records that aren't owned by a table generate their
+   /// computed values when they're parsed.
+   ///
+   /// Generators should only depend on parsed properties, not on other computed properties.
+   ///
+   template<EnumType PropT, PropertyMapType PropMapT>
+   struct ComputedField
+   {
+      using Prop        = PropT;
+      using PropertyMap = PropMapT;
+      using PropertyVal = PropertyMap::mapped_type;
+      using Generator   = PropertyVal(*)(const PropertyMap&);
+
+      Prop      prop_id{};
+      Generator generate{};
+   };
+
+} // namespace ctb::detail
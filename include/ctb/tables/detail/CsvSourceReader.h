@@ -0,0 +1,166 @@
+/*******************************************************************
+* @file  CsvSourceReader.h
+*
+* @brief defines the CsvSourceReader and CsvSourceRow classes, for
+*        splitting CSV text into fields without copying it.
+*
+* @copyright Copyright © 2025 Jeff Kohn. All rights reserved.
+*******************************************************************/
+#pragma once
+
+#include "ctb/ctb.h"
+
+#include <external/csv.hpp>
+
+#include <span>
+#include <string_view>
+#include <vector>
+
+
+namespace ctb::detail
+{
+
+   /// @brief a row of CSV fields that are views into the source text they were read from
+   ///
+   /// This provides the same operator[] as csv::CSVRow, so records can be parsed from either one.
+   ///
+   class CsvSourceRow
+   {
+   public:
+      auto size()  const noexcept -> size_t { return m_fields.size();  }
+      auto empty() const noexcept -> bool   { return m_fields.empty(); }
+
+      /// @brief get the field at the specified column index
+      /// @throws std::out_of_range if the row doesn't have that many fields
+      auto operator[](size_t idx) const -> csv::CSVField
+      {
+         return csv::CSVField{ m_fields.at(idx) };
+      }
+
+   private:
+      std::vector<std::string_view> m_fields{};
+
+      friend class CsvSourceReader;
+   };
+
+
+   /// @brief splits CSV text into rows of fields, in place.
+   ///
+   /// Unlike csv::CSVReader, the fields returned by this class are views into the supplied text rather than
+   /// into the parser's own buffers, so they remain valid for as long as the text does. To make that possible,
+   /// quoted fields are unquoted in place. Collapsing escaped quotes ("") can only make a field shorter, so the
+   /// text never needs to grow, but it does get modified and can only be read once.
+   ///
+   /// Rows are separated by line breaks outside of quoted fields, and blank lines are skipped.
+   ///
+   class CsvSourceReader
+   {
+   public:
+      explicit CsvSourceReader(std::span<char> text) noexcept : m_text{ text }
+      {
+         constexpr std::string_view utf8_bom{ "\xEF\xBB\xBF" };
+         if (std::string_view{ m_text.data(), m_text.size() }.starts_with(utf8_bom))
+         {
+            m_pos = utf8_bom.size();
+         }
+      }
+
+      /// @brief read the next row of fields
+      /// @return true if a row was read, false if there are no more rows.
+      auto readRow(CsvSourceRow& row) -> bool
+      {
+         row.m_fields.clear();
+
+         while (m_pos < m_text.size() and isLineBreak(m_text[m_pos]))
+         {
+            ++m_pos;
+         }
+         if (m_pos >= m_text.size())
+            return false;
+
+         while (readField(row))
+         {}
+
+         return true;
+      }
+
+      CsvSourceReader() = delete;
+      CsvSourceReader(const CsvSourceReader&) = delete;
+      CsvSourceReader(CsvSourceReader&&) = default;
+      CsvSourceReader& operator=(const CsvSourceReader&) = delete;
+      CsvSourceReader& operator=(CsvSourceReader&&) = default;
+      ~CsvSourceReader() noexcept = default;
+
+   private:
+      static constexpr char Delimiter = ',';
+      static constexpr char Quote     = '"';
+
+      std::span<char> m_text{};
+      size_t          m_pos{};
+
+      static auto isLineBreak(char ch) noexcept -> bool
+      {
+         return ch == '\n' or ch == '\r';
+      }
+
+      /// @brief read the field at the current position and add it to the row.
+      /// @return true if there's another field in this row, false if this was the last one.
+      auto readField(CsvSourceRow& row) -> bool
+      {
+         const auto size = m_text.size();
+         auto* text = m_text.data();
+
+         if (m_pos < size and text[m_pos] == Quote)
+         {
+            // copy the quoted text over itself, collapsing escaped quotes as we go.
+            auto start = ++m_pos;
+            auto out = start;
+            while (m_pos < size)
+            {
+               if (text[m_pos] == Quote)
+               {
+                  if (m_pos + 1 < size and text[m_pos + 1] == Quote)
+                  {
+                     text[out++] = Quote;
+                     m_pos += 2;
+                     continue;
+                  }
+                  ++m_pos;
+                  break;
+               }
+               text[out++] = text[m_pos++];
+            }
+            row.m_fields.emplace_back(text + start, out - start);
+
+            // ignore anything between the closing quote and the end of the field.
+            while (m_pos < size and text[m_pos] != Delimiter and not isLineBreak(text[m_pos]))
+            {
+               ++m_pos;
+            }
+         }
+         else {
+            auto start = m_pos;
+            while (m_pos < size and text[m_pos] != Delimiter and not isLineBreak(text[m_pos]))
+            {
+               ++m_pos;
+            }
+            row.m_fields.emplace_back(text + start, m_pos - start);
+         }
+
+         if (m_pos < size and text[m_pos] == Delimiter)
+         {
+            ++m_pos;
+            return true;
+         }
+
+         // consume the line break ending the row (readRow() will skip any that follow)
+         if (m_pos < size)
+         {
+            ++m_pos;
+         }
+         return false;
+      }
+   };
+
+
+} // namespace ctb::detail
@@ -0,0 +1,341 @@
+/*******************************************************************
+* @file  DataTable.h
+*
+* @brief defines the template class DataTable
+*
+* @copyright Copyright © 2025 Jeff Kohn. All rights reserved.
+*******************************************************************/
+#pragma once
+
+#include "ctb/ctb.h"
+#include "ctb/tables/detail/TableIndex.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+#include <vector>
+
+
+namespace ctb::detail
+{
+
+   /// @brief container of table records that owns a monotonic arena for all record storage
+   ///
+   /// Records are constructed with a pointer to this table's arena, so their property storage is
+   /// bump-allocated during load instead of doing many small heap allocations per row. Nothing is
+   /// returned to the arena until the table itself is destroyed, at which point the whole arena is
+   /// released in one shot.
+   ///
+   /// The arena is heap-allocated so that its address remains stable when the table is moved; records
+   /// hold a pointer to it. Records copied out of the table use the default memory resource, so they
+   /// remain valid after the table is destroyed.
+   ///
+   /// For records with lazy fields, the table also owns a buffer with those fields' text, which they
+   /// reference rather than each being copied to the arena (see retainLazyText()).
+   ///
+   /// Computed fields are generated for every record in the table the first time materialize() is called
+   /// for them. That's the only way records change once the table is loaded, and it's safe to call from
+   /// multiple threads (e.g. datasets sharing the table), so a const table can still be shared freely.
+   /// Indexes (wineIdIndex() and keyIndex()) are likewise built the first time they're requested.
+   ///
+   template<TableRecordType RecordT>
+   class DataTable
+   {
+   public:
+      using Record          = RecordT;
+      using Records         = std::vector<Record>;
+      using value_type      = Records::value_type;
+      using size_type       = Records::size_type;
+      using reference       = Records::reference;
+      using const_reference = Records::const_reference;
+      using iterator        = Records::iterator;
+      using const_iterator  = Records::const_iterator;
+      using ArenaPtr        = std::unique_ptr<std::pmr::monotonic_buffer_resource>;
+      using Prop            = Record::Prop;
+      using Traits          = Record::Traits;
+      using PropertyVal     = Record::PropertyVal;
+      using WineIdIndex     = TableIndex<uint64_t>;
+
+      /// @brief the values of a record's Traits::PrimaryKey properties, in the same order
+      using PrimaryKey = std::array<PropertyVal, Traits::PrimaryKey.size()>;
+
+      /// @brief hash function for PrimaryKey, combining the hashes of its values
+      struct PrimaryKeyHash
+      {
+         auto operator()(const PrimaryKey& key) const noexcept -> size_t
+         {
+            size_t result{};
+            for (const auto& val : key)
+            {
+               result = result * 31 + val.hash();
+            }
+            return result;
+         }
+      };
+      using PrimaryKeyIndex = TableIndex<PrimaryKey, PrimaryKeyHash>;
+
+      /// @brief construct a record in-place at the end of the table, using this table's arena for its storage
+      template<typename... Args>
+      auto emplace_back(Args&&... args) -> reference
+      {
+         auto& rec = m_records.emplace_back(std::forward<Args>(args)..., arena());
+
+         if (m_lazy)
+         {
+            // if a computed field has already been generated for the rest of the table, the new record needs it too.
+            for (size_t idx = 0; idx < ComputedCount; ++idx)
+            {
+               if (m_lazy->generated[idx].load(std::memory_order_relaxed))
+               {
+                  rec.computeField(Traits::ComputedFields[idx], m_arena.get());
+               }
+            }
+
+            // indexes will be rebuilt next time they're needed.
+            m_lazy->wine_ids_built.store(false, std::memory_order_relaxed);
+            m_lazy->wine_ids = {};
+            m_lazy->keys_built.store(false, std::memory_order_relaxed);
+            m_lazy->keys = {};
+         }
+         return rec;
+      }
+
+      /// @brief generate the values of a computed field for every record in the table, if that hasn't been done yet.
+      ///
+      /// Does nothing if prop_id isn't a computed field. This must be called before reading a computed field's
+      /// values from the table's records, otherwise they'll be null.
+      ///
+      void materialize(Prop prop_id) const
+      {
+         auto idx = computedIndex(prop_id);
+         if (idx == ComputedCount or !m_lazy or m_lazy->generated[idx].load(std::memory_order_acquire))
+            return;
+
+         std::scoped_lock lock{ m_lazy->mutex };
+         if (m_lazy->generated[idx].load(std::memory_order_relaxed))
+            return;
+
+         for (auto& rec : m_records)
+         {
+            rec.computeField(Traits::ComputedFields[idx], m_arena.get());
+         }
+         m_lazy->generated[idx].store(true, std::memory_order_release);
+      }
+
+      /// @brief generate the values of any computed fields in the specified range of properties
+      template<rng::input_range Rng>
+      void materialize(Rng&& props) const
+      {
+         for (Prop prop_id : props)
+         {
+            materialize(prop_id);
+         }
+      }
+
+      /// @brief generate the values of all computed fields
+      void materializeAll() const
+      {
+         for (const auto& field : Traits::ComputedFields)
+         {
+            materialize(field.prop_id);
+         }
+      }
+
+      /// @brief reserve space for the specified number of records
+      void reserve(size_type count)
+      {
+         m_records.reserve(count);
+      }
+
+      /// @brief returns the memory resource used for record storage in this table
+      auto arena() -> std::pmr::memory_resource*
+      {
+         if (!m_arena)
+            m_arena = std::make_unique<std::pmr::monotonic_buffer_resource>();
+
+         return m_arena.get();
+      }
+
+      auto size()  const noexcept -> size_type { return m_records.size();  }
+      auto empty() const noexcept -> bool      { return m_records.empty(); }
+
+      auto begin()        noexcept -> iterator       { return m_records.begin(); }
+      auto end()          noexcept -> iterator       { return m_records.end();   }
+      auto begin()  const noexcept -> const_iterator { return m_records.begin(); }
+      auto end()    const noexcept -> const_iterator { return m_records.end();   }
+
+      auto operator[](size_type idx)       -> reference       { return m_records[idx];    }
+      auto operator[](size_type idx) const -> const_reference { return m_records[idx];    }
+      auto at(size_type idx)               -> reference       { return m_records.at(idx); }
+      auto at(size_type idx)         const -> const_reference { return m_records.at(idx); }
+
+      /// @brief returns an index of this table's rows by iWineId, building it the first time it's requested
+      ///
+      /// Most tables have one row per wine, but some (e.g. tasting notes) can have several. Rows without
+      /// an iWineId aren't indexed. Safe to call from multiple threads.
+      ///
+      auto wineIdIndex() const -> const WineIdIndex&
+      {
+         return lazyIndex(&LazyState::wine_ids_built, &LazyState::wine_ids, [this](size_t row) -> std::optional<uint64_t>
+            {
+               return m_records[row].getProperty(Prop::iWineId).asUInt64();
+            });
+      }
+
+      /// @brief returns an index of this table's rows by Traits::PrimaryKey, building it the first time it's requested
+      ///
+      /// Primary keys should be unique, but that isn't enforced here, so a key may map to more than one row if the 
+      /// data is bad. Rows with a null value for any key property aren't indexed. Safe to call from multiple threads.
+      ///
+      auto keyIndex() const -> const PrimaryKeyIndex&
+      {
+         return lazyIndex(&LazyState::keys_built, &LazyState::keys, [this](size_t row) -> std::optional<PrimaryKey>
+            {
+               auto key = makeKey(m_records[row]);
+               if (rng::any_of(key, [](const PropertyVal& val) { return val.isNull(); }))
+                  return std::nullopt;
+
+               return key;
+            });
+      }
+
+      /// @brief returns the PrimaryKey values for a record
+      static auto makeKey(const Record& rec) -> PrimaryKey
+      {
+         PrimaryKey key{};
+         rng::transform(Traits::PrimaryKey, key.begin(), [&rec](Prop prop_id) { return rec.getProperty(prop_id); });
+         return key;
+      }
+
+      /// @brief copy the text that lazy fields reference in source to a buffer owned by the table
+      /// 
+      /// Records parsed from source text reference it for their lazy fields, so this must be called once 
+      /// the records parsed from it have been added, before source is released. Only the lazy fields' text
+      /// is kept, packed into a single allocation, so the rest of the source text doesn't have to outlive the 
+      /// load. A table parsed in batches calls this once per batch, with the index of the batch's first record.
+      /// 
+      void retainLazyText(std::span<const char> source, size_type first_record = 0)
+      {
+         using PropertyVal = Record::PropertyVal;
+
+         // inline strings are stored in the value itself, so they don't reference source
+         auto references_source = [source](const PropertyVal& val)
+            {
+               if (!val.hasString())
+                  return false;
+
+               auto str = val.asStringView();
+               std::less_equal<const char*> less_eq{};
+               return !str.empty() and less_eq(source.data(), str.data()) and less_eq(str.data() + str.size(), source.data() + source.size());
+            };
+
+         auto records = std::span{ m_records }.subspan(std::min(first_record, m_records.size()));
+
+         size_t total_bytes{};
+         for (auto& rec : records)
+         {
+            rec.visitLazyFields([&](const PropertyVal& val)
+               {
+                  if (references_source(val))
+                     total_bytes += val.asStringView().size();
+               });
+         }
+
+         Buffer text(total_bytes);
+         auto* out = reinterpret_cast<char*>(text.data());
+         for (auto& rec : records)
+         {
+            rec.visitLazyFields([&](PropertyVal& val)
+               {
+                  if (!references_source(val))
+                     return;
+
+                  auto str = val.asStringView();
+                  std::memcpy(out, str.data(), str.size());
+                  val = PropertyVal::makeView({ out, str.size() });
+                  out += str.size();
+               });
+         }
+         if (total_bytes)
+            m_lazy_text.push_back(std::move(text));
+      }
+
+      /// @brief returns the index of a record owned by this table. 
+      auto indexOf(const Record* rec) const noexcept -> size_type
+      {
+         assert(rec >= m_records.data() and rec < m_records.data() + m_records.size());
+         return static_cast<size_type>(rec - m_records.data());
+      }
+
+      DataTable() : m_lazy{ std::make_unique<LazyState>() }
+      {}
+      DataTable(DataTable&&) = default;
+      DataTable& operator=(DataTable&&) = default;
+      ~DataTable() noexcept = default;
+
+      // records hold pointers into our arena, so copying the table would leave them pointing at the wrong one.
+      DataTable(const DataTable&) = delete;
+      DataTable& operator=(const DataTable&) = delete;
+
+   private:
+      static constexpr size_t ComputedCount = Traits::ComputedFields.size();
+
+      /// @brief state for the computed fields and indexes that are generated on demand for a const table
+      struct LazyState
+      {
+         std::mutex                                   mutex{};
+         std::array<std::atomic<bool>, ComputedCount> generated{};     // which computed fields have been generated
+         std::atomic<bool>                            wine_ids_built{};
+         WineIdIndex                                  wine_ids{};
+         std::atomic<bool>                            keys_built{};
+         PrimaryKeyIndex                              keys{};
+      };
+      using LazyStatePtr    = std::unique_ptr<LazyState>;
+      using LazyTextBuffers = std::vector<Buffer>;  // a Buffer's storage doesn't move along with it, so views stay valid
+
+      LazyTextBuffers  m_lazy_text{};  // text referenced by lazy fields, one buffer per retainLazyText() call
+      ArenaPtr         m_arena{};      // must be declared before m_records, so it's destroyed after them
+      LazyStatePtr     m_lazy{};       // heap-allocated because it can't be moved
+      mutable Records  m_records{};    // mutable so materialize() can generate computed fields for a const table
+
+      /// @brief returns one of the indexes in m_lazy, building it if that hasn't been done yet
+      template<typename IndexT, typename KeyFuncT>
+      auto lazyIndex(std::atomic<bool> LazyState::* built, IndexT LazyState::* index, KeyFuncT&& get_key) const -> const IndexT&
+      {
+         static const IndexT empty_index{};
+         if (!m_lazy)
+            return empty_index;
+
+         if (!(m_lazy.get()->*built).load(std::memory_order_acquire))
+         {
+            std::scoped_lock lock{ m_lazy->mutex };
+            if (!(m_lazy.get()->*built).load(std::memory_order_relaxed))
+            {
+               m_lazy.get()->*index = IndexT{ m_records.size(), std::forward<KeyFuncT>(get_key) };
+               (m_lazy.get()->*built).store(true, std::memory_order_release);
+            }
+         }
+         return m_lazy.get()->*index;
+      }
+
+      /// @return the index of prop_id in Traits::ComputedFields, or ComputedCount if it's not there
+      static constexpr auto computedIndex(Prop prop_id) noexcept -> size_t
+      {
+         for (size_t idx = 0; idx < ComputedCount; ++idx)
+         {
+            if (Traits::ComputedFields[idx].prop_id == prop_id)
+               return idx;
+         }
+         return ComputedCount;
+      }
+   };
+
+
+} // namespace ctb::detail
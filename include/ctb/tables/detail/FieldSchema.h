@@ -19,14 +19,23 @@ namespace ctb::detail
    };
 
    /// @brief  contains the property type and CSV column index for a given Prop
+   ///
+   /// Lazy fields are String fields that aren't needed until they're displayed (e.g. notes). When a table
+   /// with lazy fields is loaded from disk, those fields reference the file's text while it's parsed, and 
+   /// are then packed into a single buffer kept by the table instead of being copied into its arena row by row.
+   ///
    template<typename PropT> requires std::is_enum_v<PropT>
    struct FieldSchema
    {
       using Prop = PropT;
 
+      /// @brief readability constant for the 'lazy' member when declaring a schema
+      static constexpr bool Lazy = true;
+
       Prop           prop_id{};
       PropType       prop_type{};
       NullableShort  csv_col{};   // will be std::nullopt for custom fields not in the CSV
+      bool           lazy{};      // only supported for PropType::String fields with a csv_col
    };
 
 }
\ No newline at end of file
@@ -8,7 +8,6 @@
 #pragma once
 
 #include "ctb/ctb.h"
-#include "ctb/tables/detail/PropertyValue.h"
 
 #include <string>
 #include <string_view>
@@ -59,16 +58,17 @@ namespace ctb::detail
       /// @brief How the column header should be aligned
       Align header_align{ Align::Left }; 
 
-      /// @brief for numeric fields, how many decimal places
-      uint16_t decimal_places{ 1 };
-
       /// @brief construct a column to display the specified property as a string
       ListColumn(Prop prop_id, std::string_view col_name) : prop_id{ prop_id },  display_name{ col_name }
-      {}
+      {
+         setDecimalPlaces(m_decimal_places);
+      }
 
       /// @brief construct a column to display the specified property in the requested format
-      ListColumn(Prop prop_id, Format fmt, std::string_view col_name, uint16_t decimal_places = 0) :  prop_id{ prop_id },  display_name{ col_name }, format{ fmt }, decimal_places{ decimal_places }
+      ListColumn(Prop prop_id, Format fmt, std::string_view col_name, uint16_t decimal_places = 0) :  prop_id{ prop_id },  display_name{ col_name }, format{ fmt }
       {
+         setDecimalPlaces(decimal_places);
+
          switch (format)
          {
             case Format::Currency:  [[fallthrough]];
@@ -100,19 +100,34 @@ namespace ctb::detail
          format{ fmt }, 
          col_align{ col_align },
          header_align{ head_align }
-      {}
+      {
+         setDecimalPlaces(m_decimal_places);
+      }
+
+      /// @brief for numeric fields, how many decimal places
+      auto decimalPlaces() const noexcept -> uint16_t
+      {
+         return m_decimal_places;
+      }
+
+      /// @brief set the number of decimal places for numeric fields
+      void setDecimalPlaces(uint16_t decimal_places)
+      {
+         m_decimal_places = decimal_places;
+         m_decimal_fmt = ctb::format("{{:.{}f}}", decimal_places);
+      }
 
       /// @brief get the display text for a property value, which may include special formatting
       ///
-      /// currency values will use a dollar sign and 2 decimal places, decimal values will use decimal_places
-      template<typename... Args>
-      std::string getDisplayValue(const detail::PropertyValue<Args...>& prop_value) const
+      /// currency values will use a dollar sign and 2 decimal places, decimal values will use decimalPlaces()
+      template<PropertyValueType PropertyValT>
+      std::string getDisplayValue(const PropertyValT& prop_value) const
       {
          std::string result{};
          switch (format)
          {
             case Format::Decimal:
-               result = prop_value.asString(ctb::format("{{:.{}f}}", decimal_places));
+               result = prop_value.asString(m_decimal_fmt);
                break;
 
             case Format::Currency:  
@@ -130,12 +145,19 @@ namespace ctb::detail
          return result;
       }
 
-      ListColumn() = default;
+      ListColumn() 
+      {
+         setDecimalPlaces(m_decimal_places);
+      }
       ListColumn(const ListColumn&) = default;
       ListColumn(ListColumn&&) = default;
       ListColumn& operator=(const ListColumn&) = default;
       ListColumn& operator=(ListColumn&&) = default;
       ~ListColumn() = default;
+
+   private:
+      uint16_t    m_decimal_places{ 1 };
+      std::string m_decimal_fmt{};      // format string for Decimal columns, built whenever m_decimal_places is set
    };
 
 } // namespace ctb::detail
\ No newline at end of file
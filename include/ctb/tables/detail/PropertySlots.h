@@ -0,0 +1,236 @@
+/*******************************************************************
+* @file  PropertySlots.h
+*
+* @brief defines the PropertySlots and SlottedPropertyMap templates,
+*        which provide fixed-slot storage for table record properties.
+*
+* @copyright Copyright © 2025 Jeff Kohn. All rights reserved.
+*******************************************************************/
+#pragma once
+
+#include "ctb/ctb.h"
+
+#include <magic_enum/magic_enum.hpp>
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+
+namespace ctb::detail
+{
+
+   /// @brief type used to index a property's slot within a record
+   using SlotIndex = uint8_t;
+
+   /// @brief sentinel value indicating a property has no slot (e.g. isn't part of the schema)
+   inline constexpr SlotIndex NoSlot = std::numeric_limits<SlotIndex>::max();
+
+
+   /// @brief compile-time mapping from a traits class's properties to dense slot indexes.
+   ///
+   /// Slots are assigned in the order properties appear in Traits::Schema, so a record for the
+   /// traits class can store its values in an array of Schema.size() elements, and a property lookup
+   /// is just two array indexes instead of a hash.
+   ///
+   template<typename TraitsT>
+   struct PropertySlots
+   {
+      using Prop = TraitsT::Prop;
+
+      /// @brief number of slots (e.g. properties) needed for a record of this table
+      static constexpr size_t SlotCount = TraitsT::Schema.size();
+
+      /// @brief size of the lookup table mapping Prop values to slot indexes
+      static constexpr size_t IndexSize = static_cast<size_t>(std::to_underlying(magic_enum::enum_values<Prop>().back())) + 1;
+
+      static_assert(SlotCount < NoSlot, "Schema has too many properties for SlotIndex type");
+
+      /// @brief lookup table of slot indexes, indexed by the underlying value of a Prop
+      static constexpr std::array<SlotIndex, IndexSize> Index = []
+         {
+            std::array<SlotIndex, IndexSize> index{};
+            index.fill(NoSlot);
+
+            SlotIndex slot{};
+            for (const auto& entry : TraitsT::Schema)
+            {
+               index[static_cast<size_t>(std::to_underlying(entry.first))] = slot++;
+            }
+            return index;
+         }();
+
+      /// @brief the Prop stored in each slot, indexed by slot
+      static constexpr std::array<Prop, SlotCount> Props = []
+         {
+            std::array<Prop, SlotCount> props{};
+
+            size_t slot{};
+            for (const auto& entry : TraitsT::Schema)
+            {
+               props[slot++] = entry.first;
+            }
+            return props;
+         }();
+
+      /// @return the slot index for the specified property, or NoSlot if it's not part of the schema
+      static constexpr auto slotOf(Prop prop_id) noexcept -> SlotIndex
+      {
+         auto idx = static_cast<size_t>(std::to_underlying(prop_id));
+         return idx < IndexSize ? Index[idx] : NoSlot;
+      }
+   };
+
+
+   /// @brief lightweight map-like view over a record's slot array.
+   ///
+   /// This class implements the parts of the associative container interface needed by our filters,
+   /// sorters and traits classes (find/contains/operator[]/iteration), so that they can remain table-neutral
+   /// even though each table's records store their values in a fixed-size array specific to that table.
+   ///
+   /// This is a view, it does not own the values. It's only valid for the lifetime of the record it was
+   /// obtained from. Constness is deep, e.g. a const SlottedPropertyMap only provides const access to values.
+   /// 
+   /// If IsReadOnly is true, the view never provides non-const access to values (see ConstSlottedPropertyMap), 
+   /// which is what const records hand out. Copying a read-only view can't be used to get write access to 
+   /// the values, unlike copying a const SlottedPropertyMap.
+   ///
+   template<EnumType PropT, typename PropertyValT, bool IsReadOnly = false>
+   class SlottedPropertyMap
+   {
+   public:
+      using key_type    = PropT;
+      using mapped_type = PropertyValT;
+      using size_type   = size_t;
+      using ValuePtr    = std::conditional_t<IsReadOnly, const mapped_type*, mapped_type*>;
+
+      /// @brief iterator over the (prop, value) pairs in the map, in slot order.
+      template<bool IsConst>
+      class Iterator
+      {
+      public:
+         using ValueRef   = std::conditional_t<IsConst, const mapped_type&, mapped_type&>;
+         using value_type = std::pair<const key_type, ValueRef>;
+         using MapPtr     = std::conditional_t<IsConst, const SlottedPropertyMap*, SlottedPropertyMap*>;
+
+         /// @brief allows it->second syntax, since we don't actually store pairs
+         struct ArrowProxy
+         {
+            value_type pair;
+            auto operator->() -> value_type* { return &pair; }
+         };
+
+         auto operator*()  const -> value_type { return { m_map->m_props[m_slot], m_map->m_values[m_slot] }; }
+         auto operator->() const -> ArrowProxy { return ArrowProxy{ **this };                               }
+
+         auto operator++() -> Iterator&   { ++m_slot; return *this;                     }
+         auto operator++(int) -> Iterator { auto tmp = *this; ++m_slot; return tmp;    }
+
+         auto operator==(const Iterator&) const -> bool = default;
+
+         Iterator() = default;
+         Iterator(MapPtr map, size_t slot) : m_map{ map }, m_slot{ slot }
+         {}
+
+      private:
+         MapPtr m_map{};
+         size_t m_slot{};
+      };
+
+      using iterator       = Iterator<IsReadOnly>;
+      using const_iterator = Iterator<true>;
+
+      /// @brief construct a map for the specified traits class's slots and values.
+      template<typename TraitsT>
+      SlottedPropertyMap(PropertySlots<TraitsT>, std::span<std::remove_pointer_t<ValuePtr>, PropertySlots<TraitsT>::SlotCount> values) noexcept :
+         m_index{ PropertySlots<TraitsT>::Index },
+         m_props{ PropertySlots<TraitsT>::Props },
+         m_values{ values.data() }
+      {}
+
+      /// @brief construct a read-only view of the same values as a writable one.
+      SlottedPropertyMap(const SlottedPropertyMap<PropT, PropertyValT, false>& other) noexcept requires IsReadOnly :
+         m_index{ other.m_index },
+         m_props{ other.m_props },
+         m_values{ other.m_values }
+      {}
+
+      auto size()  const noexcept -> size_type { return m_props.size();  }
+      auto empty() const noexcept -> bool      { return m_props.empty(); }
+
+      auto begin()       noexcept -> iterator       { return iterator{ this, 0 };                   }
+      auto end()         noexcept -> iterator       { return iterator{ this, size() };              }
+      auto begin() const noexcept -> const_iterator { return const_iterator{ this, 0 };             }
+      auto end()   const noexcept -> const_iterator { return const_iterator{ this, size() };        }
+
+      auto find(key_type prop_id) noexcept -> iterator
+      {
+         auto slot = slotOf(prop_id);
+         return slot == NoSlot ? end() : iterator{ this, slot };
+      }
+
+      auto find(key_type prop_id) const noexcept -> const_iterator
+      {
+         auto slot = slotOf(prop_id);
+         return slot == NoSlot ? end() : const_iterator{ this, slot };
+      }
+
+      auto contains(key_type prop_id) const noexcept -> bool
+      {
+         return slotOf(prop_id) != NoSlot;
+      }
+
+      /// @brief access the value for the specified property
+      ///
+      /// Unlike a real map, this can't insert new properties, only those in the table's Schema
+      /// have storage. Asking for anything else is a bug.
+      ///
+      /// @throws ctb::Error if prop_id is not part of the table's Schema
+      template<typename Self>
+      auto& operator[](this Self&& self, key_type prop_id) noexcept(false)
+      {
+         auto slot = self.slotOf(prop_id);
+         if (slot == NoSlot)
+         {
+            assert(false and "property is not part of the table schema, this is a bug!");
+            throw Error{ "property is not part of the table schema, this is a bug!" };
+         }
+         return std::forward<Self>(self).valueAt(slot);
+      }
+
+      SlottedPropertyMap() = delete;
+      SlottedPropertyMap(const SlottedPropertyMap&) = default;
+      SlottedPropertyMap(SlottedPropertyMap&&) = default;
+      SlottedPropertyMap& operator=(const SlottedPropertyMap&) = default;
+      SlottedPropertyMap& operator=(SlottedPropertyMap&&) = default;
+      ~SlottedPropertyMap() noexcept = default;
+
+   private:
+      std::span<const SlotIndex> m_index{};
+      std::span<const key_type>  m_props{};
+      ValuePtr                   m_values{};
+
+      template<EnumType, typename, bool>
+      friend class SlottedPropertyMap;
+
+      auto slotOf(key_type prop_id) const noexcept -> size_t
+      {
+         auto idx = static_cast<size_t>(std::to_underlying(prop_id));
+         return idx < m_index.size() ? m_index[idx] : NoSlot;
+      }
+
+      auto valueAt(size_t slot)       -> std::remove_pointer_t<ValuePtr>& { return m_values[slot]; }
+      auto valueAt(size_t slot) const -> const mapped_type&               { return m_values[slot]; }
+   };
+
+
+   /// @brief read-only map-like view over a record's slot array, see SlottedPropertyMap
+   template<EnumType PropT, typename PropertyValT>
+   using ConstSlottedPropertyMap = SlottedPropertyMap<PropT, PropertyValT, true>;
+
+
+} // namespace ctb::detail
@@ -0,0 +1,144 @@
+/*******************************************************************
+* @file  TableDiff.h
+*
+* @brief defines the TableDelta struct and diffTables() function, 
+*        for finding the differences between two versions of a table
+*
+* @copyright Copyright © 2025 Jeff Kohn. All rights reserved.
+*******************************************************************/
+#pragma once
+
+#include "ctb/ctb.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+
+namespace ctb::detail
+{
+
+   /// @brief the differences between two versions of the same table, matching records on the table's PrimaryKey
+   ///
+   struct TableDelta
+   {
+      /// @brief value in old_to_new for a record that isn't in the new table
+      static constexpr size_t NoMatch = std::numeric_limits<size_t>::max();
+
+      std::vector<size_t> old_to_new{};   // for each record in the old table, the index of the same record in the new table (or NoMatch)
+      std::vector<size_t> inserted{};     // indexes of records in the new table that aren't in the old table
+      std::vector<size_t> updated{};      // indexes of records in the new table that are in the old table with different values
+      std::vector<size_t> deleted{};      // indexes of records in the old table that aren't in the new table
+
+      /// @brief returns true if there are no differences between the tables.
+      auto empty() const noexcept -> bool
+      {
+         return inserted.empty() and updated.empty() and deleted.empty();
+      }
+   };
+
+
+   /// @brief compare two versions of a table to find inserted, updated and deleted records
+   ///
+   /// Records are matched on their traits class's PrimaryKey. Both tables are indexed by sorting
+   /// their keys, so this is O(n log n) regardless of how many records changed. 
+   /// 
+   /// @return the differences between the tables, or std::nullopt if either table contains a null or 
+   ///         duplicate key, since in that case records can't be reliably matched.
+   /// 
+   template<DataTableType DataTableT>
+   auto diffTables(const DataTableT& old_data, const DataTableT& new_data) -> std::optional<TableDelta>
+   {
+      using Record      = DataTableT::value_type;
+      using Traits      = Record::Traits;
+      using Prop        = Traits::Prop;
+      using PropertyVal = Record::PropertyVal;
+      using RecordKey   = std::array<const PropertyVal*, Traits::PrimaryKey.size()>;
+      using KeyedIndex  = std::pair<RecordKey, size_t>;
+
+      // keys point into the records rather than copying values, the tables outlive the index.
+      auto compareKeys = [](const RecordKey& key1, const RecordKey& key2) -> std::partial_ordering
+         {
+            for (auto [val1, val2] : vws::zip(key1, key2))
+            {
+               if (auto cmp = *val1 <=> *val2; cmp != 0)
+                  return cmp;
+            }
+            return std::partial_ordering::equivalent;
+         };
+
+      auto makeIndex = [&compareKeys](const DataTableT& data) -> std::optional<std::vector<KeyedIndex>>
+         {
+            std::vector<KeyedIndex> index{};
+            index.reserve(data.size());
+            for (size_t idx = 0; idx < data.size(); ++idx)
+            {
+               RecordKey key{};
+               rng::transform(Traits::PrimaryKey, key.begin(), [&data, idx](Prop prop_id) { return &data[idx][prop_id]; });
+               if (rng::any_of(key, [](const PropertyVal* val) { return val->isNull(); }))
+                  return std::nullopt;
+
+               index.emplace_back(key, idx);
+            }
+
+            auto keyLess = [&compareKeys](const KeyedIndex& lhs, const KeyedIndex& rhs) { return compareKeys(lhs.first, rhs.first) < 0; };
+            auto keyEqual = [&compareKeys](const KeyedIndex& lhs, const KeyedIndex& rhs) { return compareKeys(lhs.first, rhs.first) == 0; };
+
+            rng::sort(index, keyLess);
+            if (rng::adjacent_find(index, keyEqual) != index.end())
+               return std::nullopt;
+
+            return index;
+         };
+
+      auto old_index = makeIndex(old_data);
+      auto new_index = makeIndex(new_data);
+      if (!old_index or !new_index)
+         return std::nullopt;
+
+      TableDelta delta{};
+      delta.old_to_new.assign(old_data.size(), TableDelta::NoMatch);
+
+      // both indexes are sorted by key, so we can just walk them together
+      auto old_it = old_index->begin();
+      auto new_it = new_index->begin();
+      while (old_it != old_index->end() and new_it != new_index->end())
+      {
+         auto cmp = compareKeys(old_it->first, new_it->first);
+         if (cmp < 0)
+         {
+            delta.deleted.push_back(old_it->second);
+            ++old_it;
+         }
+         else if (cmp > 0)
+         {
+            delta.inserted.push_back(new_it->second);
+            ++new_it;
+         }
+         else 
+         {
+            delta.old_to_new[old_it->second] = new_it->second;
+            if (not (old_data[old_it->second] == new_data[new_it->second]))
+            {
+               delta.updated.push_back(new_it->second);
+            }
+            ++old_it;
+            ++new_it;
+         }
+      }
+      for (; old_it != old_index->end(); ++old_it)
+      {
+         delta.deleted.push_back(old_it->second);
+      }
+      for (; new_it != new_index->end(); ++new_it)
+      {
+         delta.inserted.push_back(new_it->second);
+      }
+      return delta;
+   }
+
+
+} // namespace ctb::detail
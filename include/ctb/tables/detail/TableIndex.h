@@ -0,0 +1,122 @@
+/*******************************************************************
+* @file  TableIndex.h
+*
+* @brief defines the template class TableIndex
+*
+* @copyright Copyright © 2025 Jeff Kohn. All rights reserved.
+*******************************************************************/
+#pragma once
+
+#include "ctb/ctb.h"
+
+#include <functional>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace ctb::detail
+{
+
+   /// @brief hash index mapping a key to the rows of a table that have that key (one-to-many).
+   ///
+   /// Rows are identified by their index in the table, so the index stays valid as long as the table
+   /// isn't modified. The rows for each key are stored contiguously in a single vector, in table order,
+   /// so a lookup is one hash probe and returns a span without allocating.
+   ///
+   template<typename KeyT, typename HashT = std::hash<KeyT>, typename KeyEqualT = std::equal_to<KeyT>>
+   class TableIndex
+   {
+   public:
+      using Key     = KeyT;
+      using RowSpan = std::span<const size_t>;
+
+      /// @brief build an index for a table with the specified number of rows
+      ///
+      /// @param row_count - number of rows in the table
+      /// @param get_key - callable that takes a row index and returns std::optional<Key>. Rows without a key
+      ///  (std::nullopt) aren't indexed.
+      template<typename KeyFuncT>
+      TableIndex(size_t row_count, KeyFuncT&& get_key)
+      {
+         std::vector<std::pair<Key, size_t>> keyed{};
+         keyed.reserve(row_count);
+         for (size_t row = 0; row < row_count; ++row)
+         {
+            if (std::optional<Key> key = get_key(row); key)
+            {
+               keyed.emplace_back(std::move(*key), row);
+            }
+         }
+
+         // count the rows for each key so we know where each key's rows start, then fill them in.
+         for (const auto& [key, row] : keyed)
+         {
+            ++m_ranges[key].count;
+         }
+         size_t offset{};
+         for (auto& range : vws::values(m_ranges))
+         {
+            range.offset = offset;
+            offset += range.count;
+            range.count = 0;
+         }
+
+         m_rows.resize(keyed.size());
+         for (const auto& [key, row] : keyed)
+         {
+            auto& range = m_ranges[key];
+            m_rows[range.offset + range.count++] = row;
+         }
+      }
+
+      /// @return the rows with the specified key, in table order. Empty if there aren't any.
+      auto find(const Key& key) const -> RowSpan
+      {
+         auto it = m_ranges.find(key);
+         if (it == m_ranges.end())
+            return {};
+
+         return RowSpan{ m_rows }.subspan(it->second.offset, it->second.count);
+      }
+
+      /// @return true if any rows have the specified key
+      auto contains(const Key& key) const -> bool
+      {
+         return m_ranges.contains(key);
+      }
+
+      /// @return the number of distinct keys in the index
+      auto keyCount() const noexcept -> size_t
+      {
+         return m_ranges.size();
+      }
+
+      /// @return the number of rows in the index (rows without a key aren't counted)
+      auto rowCount() const noexcept -> size_t
+      {
+         return m_rows.size();
+      }
+
+      TableIndex() = default;
+      TableIndex(const TableIndex&) = default;
+      TableIndex(TableIndex&&) = default;
+      TableIndex& operator=(const TableIndex&) = default;
+      TableIndex& operator=(TableIndex&&) = default;
+      ~TableIndex() noexcept = default;
+
+   private:
+      struct RowRange
+      {
+         size_t offset{};
+         size_t count{};
+      };
+
+      std::unordered_map<Key, RowRange, HashT, KeyEqualT> m_ranges{};
+      std::vector<size_t>                                 m_rows{};
+   };
+
+
+} // namespace ctb::detail
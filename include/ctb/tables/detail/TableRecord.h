@@ -11,12 +11,16 @@
 
 #include "ctb/ctb.h"
 #include "ctb/utility_chrono.h"
+#include "ctb/tables/detail/CsvSourceReader.h"
 #include "ctb/tables/detail/FieldSchema.h"
+#include "ctb/tables/detail/PropertySlots.h"
 
 #include <external/csv.hpp>
 #include <magic_enum/magic_enum.hpp>
 
+#include <array>
 #include <cassert>
+#include <memory_resource>
 
 
 namespace ctb::detail
@@ -32,16 +36,53 @@ namespace ctb::detail
    /// template param gives us access to types from the derived class from outside function
    /// bodies (e.g. member variables).
    /// 
+   /// Property values are stored in a fixed-size array with one slot per property in Traits::Schema,
+   /// the slot for each property is determined at compile time by PropertySlots<Traits>. PropertyMapT
+   /// is a map-like view over that array, which is what getProperties() returns.
+   /// 
+   /// Values for the Traits::ComputedFields are not generated when a record owned by a DataTable is
+   /// parsed, the table generates them by calling computeField() the first time they're needed.
+   /// 
    template<RecordTraitsType RecordTraitsT, PropertyMapType PropertyMapT>
    class TableRecord
    {
    public:
-      using Traits        = RecordTraitsT;
-      using Prop          = Traits::Prop;
-      using PropType      = detail::PropType;
-      using PropertyMap   = PropertyMapT;
-      using PropertyVal   = PropertyMap::mapped_type; 
-      using RowType       = csv::CSVRow;
+      using Traits             = RecordTraitsT;
+      using Prop               = Traits::Prop;
+      using PropType           = detail::PropType;
+      using PropertyMap        = PropertyMapT;
+      using PropertyVal        = PropertyMap::mapped_type; 
+      using MutablePropertyMap = Traits::MutablePropertyMap;
+      using RowType            = csv::CSVRow;
+      using Slots              = PropertySlots<Traits>;
+      using SlotValues         = std::array<PropertyVal, Slots::SlotCount>;
+      using SourceRowType      = CsvSourceRow;
+      using ComputedField      = Traits::ComputedField;
+
+      /// @brief whether any fields in Traits::Schema are lazy, which means tables of this record type keep
+      ///        their source text when they're loaded from disk.
+      static constexpr bool HasLazyFields = []
+         {
+            bool has_lazy{ false };
+            for (const auto& entry : Traits::Schema)
+            {
+               const auto& field = entry.second;
+               assert((not field.lazy or (field.prop_type == PropType::String and field.csv_col.has_value())) and "Only CSV String fields can be lazy");
+               has_lazy = has_lazy or field.lazy;
+            }
+            return has_lazy;
+         }();
+
+      /// @brief flags indicating which slots hold computed fields, indexed by slot
+      static constexpr std::array<bool, Slots::SlotCount> ComputedSlots = []
+         {
+            std::array<bool, Slots::SlotCount> computed{};
+            for (const auto& field : Traits::ComputedFields)
+            {
+               computed[Slots::slotOf(field.prop_id)] = true;
+            }
+            return computed;
+         }();
 
       /// @brief Construct a TableRecord from a RowType
       explicit TableRecord(const RowType& row)
@@ -49,9 +90,26 @@ namespace ctb::detail
          parseRow(row);
       }
 
-      /// @brief Construct a TableRecord from a PropertyMap.
-      explicit TableRecord(PropertyMap props) : m_props{ std::move(props) }
-      {}
+      /// @brief Construct a TableRecord from a RowType, for a record owned by a DataTable
+      /// 
+      /// property values are stored inline in the record's slots, but string values too long to
+      /// store inline are allocated from the table's arena. The arena must outlive this record.
+      /// 
+      TableRecord(const RowType& row, std::pmr::memory_resource* arena)
+      {
+         parseRow(row, arena);
+      }
+
+      /// @brief Construct a TableRecord from a row of the table's source text, for a record owned by a DataTable
+      /// 
+      /// this is the same as the RowType overload, except that values for lazy fields reference the row's
+      /// text in place instead of being copied to the arena. The source text must remain valid until the 
+      /// table copies what the lazy fields need (see DataTable::retainLazyText()).
+      /// 
+      TableRecord(const SourceRowType& row, std::pmr::memory_resource* arena)
+      {
+         parseRow(row, arena);
+      }
 
       TableRecord() = default;
       TableRecord(const TableRecord&) = default;
@@ -60,7 +118,11 @@ namespace ctb::detail
 
       /// @brief parse a CSVRow into TableProperties for each property in m_props
       ///
-      void parseRow(const RowType& row)
+      /// if arena is nullptr, string values will be heap-allocated and owned by this record. Since
+      /// there's no table to generate them later, computed fields are generated immediately.
+      /// 
+      template<typename RowT = RowType>
+      void parseRow(const RowT& row, std::pmr::memory_resource* arena = nullptr)
       {
          using namespace magic_enum;
 
@@ -70,20 +132,66 @@ namespace ctb::detail
 
          for (auto& fld_schema : csv_cols)
          {
+            auto& prop_val = m_props[Slots::slotOf(fld_schema.prop_id)];
             try
             {
                auto csv_field = row[fld_schema.csv_col.value()];
-               m_props[fld_schema.prop_id] = fieldToProperty(csv_field, fld_schema.prop_type);
+               if constexpr (std::same_as<RowT, SourceRowType>)
+               {
+                  if (fld_schema.lazy)
+                  {
+                     prop_val = csv_field.is_null() ? PropertyVal{} : PropertyVal::makeView(csv_field.get<std::string_view>());
+                     continue;
+                  }
+               }
+               prop_val = fieldToProperty(csv_field, fld_schema.prop_type, arena);
             }
             catch (...)
             {
-               m_props[fld_schema.prop_id].setNull();
+               prop_val.setNull();
                SPDLOG_DEBUG("TableRecord::Parse() encountered error parsing field {}. {}", enum_name(fld_schema.prop_id), packageError().formattedMesage());
             }
          }
 
-         // give the traits class a chance to provide any missing values (calculated values not in the CSV)
-         Traits::onRecordParse(m_props);
+         // give the traits class a chance to fix up any parsed values
+         auto props = MutablePropertyMap{ Slots{}, m_props };
+         Traits::onRecordParse(props);
+
+         if (arena)
+         {
+            // any strings set by onRecordParse were heap-allocated, so move them to the arena with everything else.
+            rng::for_each(m_props, [arena](PropertyVal& val) { val.relocateString(arena); });
+         }
+         else {
+            rng::for_each(Traits::ComputedFields, [this](const ComputedField& field) { computeField(field); });
+         }
+      }
+
+      /// @brief generate the value for a computed field
+      ///
+      /// if arena is nullptr, a string value will be heap-allocated and owned by this record.
+      /// 
+      void computeField(const ComputedField& field, std::pmr::memory_resource* arena = nullptr)
+      {
+         auto& prop_val = m_props[Slots::slotOf(field.prop_id)];
+         prop_val = field.generate(PropertyMap{ Slots{}, m_props });
+         if (arena)
+         {
+            prop_val.relocateString(arena);
+         }
+      }
+
+      /// @brief calls func with the value of each of this record's lazy fields
+      ///
+      /// this lets the owning table move the text those values reference, see DataTable::retainLazyText()
+      /// 
+      template<typename FuncT>
+      void visitLazyFields(FuncT&& func)
+      {
+         for (auto& fld_schema : vws::values(Traits::Schema) | vws::filter([](auto& field) { return field.lazy; }))
+         {
+            func(m_props[Slots::slotOf(fld_schema.prop_id)]);
+         }
       }
 
       /// @brief Indicates whether the requested property is available in this record
@@ -91,7 +199,7 @@ namespace ctb::detail
       /// 
       auto hasProperty(Prop prop_id) const -> bool
       {
-         return m_props.contains(prop_id);
+         return Slots::slotOf(prop_id) != NoSlot;
       }
 
       /// @brief Get the property value corresponding to the property identifier
@@ -105,8 +213,8 @@ namespace ctb::detail
       {
          static constexpr auto null_prop = PropertyVal{};
 
-         auto it = m_props.find(prop_id);
-         return it == m_props.end() ? null_prop : it->second;
+         auto slot = Slots::slotOf(prop_id);
+         return slot == NoSlot ? null_prop : m_props[slot];
       }
 
       /// @brief Get the property value corresponding to the property identifier
@@ -121,20 +229,36 @@ namespace ctb::detail
          return getProperty(prop_id);
       }
 
-      /// @brief  Gets a reference to the map of all properties for this record.
+      /// @brief  Gets a map-like view of all properties for this record.
+      /// 
+      /// The returned view is only valid for the lifetime of this record.
       /// 
-      auto getProperties() const -> const PropertyMap&
+      auto getProperties() const -> PropertyMap
       {
-         return m_props;
+         return PropertyMap{ Slots{}, m_props };
+      }
+
+      /// @brief two records are equal if all of their parsed property values are equal
+      ///
+      /// computed values are derived from the parsed values so there's no need to compare them, and 
+      /// they may not have been generated yet.
+      auto operator==(const TableRecord& other) const -> bool
+      {
+         for (size_t slot = 0; slot < Slots::SlotCount; ++slot)
+         {
+            if (not ComputedSlots[slot] and m_props[slot] != other.m_props[slot])
+               return false;
+         }
+         return true;
       }
 
       TableRecord& operator=(const TableRecord&) = delete;
 
    private:
-      PropertyMap m_props{ Traits::Schema.size()};
+      SlotValues m_props{};
 
       // @brief converts a CSVField into a PropertyValue
-      PropertyVal fieldToProperty(csv::CSVField& fld, PropType prop_type)
+      PropertyVal fieldToProperty(csv::CSVField& fld, PropType prop_type, std::pmr::memory_resource* arena)
       {
          if (fld.is_null())
             return {};
@@ -142,7 +266,7 @@ namespace ctb::detail
          switch (prop_type)
          {
             case PropType::String:
-               return PropertyVal{ fld.get<std::string>() };
+               return arena ? PropertyVal{ fld.get<std::string_view>(), arena } : PropertyVal{ fld.get<std::string>() };
 
             case PropType::UInt16:
                return fld.is_int() ? PropertyVal{ fld.get<uint16_t>() } : PropertyVal{};
@@ -78,6 +78,14 @@ namespace ctb::detail
       return result;
    }
 
+   /// @brief Get the name of the month a bottle was consumed
+   /// @return the month name, or null if there's no consume date
+   inline auto getConsumeMonth(const CtPropertyMap& rec) -> CtPropertyVal
+   {
+      auto consume_date = getValueOrNull(rec, CtProp::ConsumeDate).asDate();
+      return consume_date ? CtPropertyVal{ ctb::format("{:%B}", *consume_date) } : CtPropertyVal{};
+   }
+
    /// @brief  Replace drink date of 9999 with null
    inline void validateDrinkYear(CtPropertyVal& prop) 
    {
@@ -0,0 +1,358 @@
+/*********************************************************************
+ * @file       CoTask.h
+ *
+ * @brief      coroutine task types and awaitables for running coroutines
+ *             on a TaskExecutor
+ *
+ * @copyright  Copyright © 2025 Jeff Kohn. All rights reserved.
+ *********************************************************************/
+#pragma once
+
+#include "ctb/ctb.h"
+#include "ctb/tasks/TaskExecutor.h"
+
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <utility>
+#include <vector>
+
+
+namespace ctb::tasks
+{
+   template<typename T>
+   class CoTask;
+
+
+   namespace detail
+   {
+      /// @brief promise functionality common to all CoTask types
+      ///
+      /// The task is lazy: the coroutine doesn't start until it's co_await'ed, and when it finishes it 
+      /// transfers control directly back to the awaiting coroutine, so a chain of CoTask's doesn't 
+      /// consume any threads while it's suspended.
+      struct CoTaskPromiseBase
+      {
+         struct FinalAwaiter
+         {
+            auto await_ready() const noexcept -> bool { return false; }
+
+            template<typename PromiseT>
+            auto await_suspend(std::coroutine_handle<PromiseT> handle) noexcept -> std::coroutine_handle<>
+            {
+               auto continuation = handle.promise().m_continuation;
+               return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+         };
+
+         std::coroutine_handle<> m_continuation{};
+         std::exception_ptr      m_exception{};
+
+         auto initial_suspend() const noexcept -> std::suspend_always { return {}; }
+         auto final_suspend()   const noexcept -> FinalAwaiter        { return {}; }
+
+         void unhandled_exception() noexcept
+         {
+            m_exception = std::current_exception();
+         }
+
+         void rethrowIfFailed() const
+         {
+            if (m_exception)
+               std::rethrow_exception(m_exception);
+         }
+      };
+
+
+      template<typename T>
+      struct CoTaskPromise : CoTaskPromiseBase
+      {
+         std::optional<T> m_value{};
+
+         auto get_return_object() noexcept -> CoTask<T>;
+
+         template<typename U = T>
+         void return_value(U&& value) 
+         {
+            m_value.emplace(std::forward<U>(value));
+         }
+
+         auto result() -> T
+         {
+            rethrowIfFailed();
+            return std::move(*m_value);
+         }
+      };
+
+
+      template<>
+      struct CoTaskPromise<void> : CoTaskPromiseBase
+      {
+         auto get_return_object() noexcept -> CoTask<void>;
+
+         void return_void() const noexcept {}
+
+         void result() const
+         {
+            rethrowIfFailed();
+         }
+      };
+
+   } // namespace detail
+
+
+   /// @brief lazily-started coroutine task that returns a value of type T to its awaiter.
+   ///
+   /// Any exception thrown by the coroutine is re-thrown from the co_await expression. Cancellation
+   /// is cooperative, coroutines should take a std::stop_token and call checkStopToken() between steps.
+   ///
+   /// Use schedule() to move a coroutine onto a TaskExecutor thread. Since a CoTask has to be awaited
+   /// to run, the top-level coroutine should be a DetachedTask.
+   /// 
+   template<typename T = void>
+   class [[nodiscard]] CoTask
+   {
+   public:
+      using promise_type = detail::CoTaskPromise<T>;
+      using Handle       = std::coroutine_handle<promise_type>;
+
+      auto operator co_await() && noexcept
+      {
+         struct Awaiter
+         {
+            Handle m_handle;
+
+            auto await_ready() const noexcept -> bool { return !m_handle or m_handle.done(); }
+
+            auto await_suspend(std::coroutine_handle<> awaiting) noexcept -> std::coroutine_handle<>
+            {
+               m_handle.promise().m_continuation = awaiting;
+               return m_handle;
+            }
+
+            auto await_resume() -> T
+            {
+               if (!m_handle)
+                  throw Error{ constants::ERROR_STR_NULLPTR_ARG };
+
+               return m_handle.promise().result();
+            }
+         };
+         return Awaiter{ m_handle };
+      }
+
+      CoTask() noexcept = default;
+      CoTask(CoTask&& other) noexcept : m_handle{ std::exchange(other.m_handle, {}) }
+      {}
+
+      CoTask& operator=(CoTask&& other) noexcept
+      {
+         if (this != &other)
+         {
+            if (m_handle)
+               m_handle.destroy();
+
+            m_handle = std::exchange(other.m_handle, {});
+         }
+         return *this;
+      }
+
+      ~CoTask() noexcept
+      {
+         if (m_handle)
+            m_handle.destroy();
+      }
+
+      CoTask(const CoTask&) = delete;
+      CoTask& operator=(const CoTask&) = delete;
+
+   private:
+      Handle m_handle{};
+
+      explicit CoTask(Handle handle) noexcept : m_handle{ handle }
+      {}
+
+      friend promise_type;
+   };
+
+
+   namespace detail
+   {
+      template<typename T>
+      auto CoTaskPromise<T>::get_return_object() noexcept -> CoTask<T>
+      {
+         return CoTask<T>{ std::coroutine_handle<CoTaskPromise<T>>::from_promise(*this) };
+      }
+
+      inline auto CoTaskPromise<void>::get_return_object() noexcept -> CoTask<void>
+      {
+         return CoTask<void>{ std::coroutine_handle<CoTaskPromise<void>>::from_promise(*this) };
+      }
+
+   } // namespace detail
+
+
+   /// @brief return type for a top-level coroutine that's started immediately and not awaited by anyone.
+   ///
+   /// The coroutine frame destroys itself when it completes. Since there's no one to report to, any
+   /// exception that escapes the coroutine is logged and discarded.
+   /// 
+   struct DetachedTask
+   {
+      struct promise_type
+      {
+         auto get_return_object() const noexcept -> DetachedTask  { return {}; }
+         auto initial_suspend()   const noexcept -> std::suspend_never { return {}; }
+         auto final_suspend()     const noexcept -> std::suspend_never { return {}; }
+
+         void return_void() const noexcept {}
+
+         void unhandled_exception() const noexcept
+         {
+            log::exception(packageError());
+         }
+      };
+   };
+
+
+   /// @brief a result that any number of coroutines can co_await, which is set once by a producer.
+   ///
+   /// This is used to share a single in-progress operation between multiple requesters. Each awaiter gets 
+   /// a copy of the value (or the exception is re-thrown to each of them), so T should be cheap to copy. 
+   /// Awaiters that suspend are resumed on the thread that sets the result.
+   ///
+   template<typename T>
+   class SharedResult final
+   {
+   public:
+      /// @brief set the result value and resume any waiting coroutines. Only the first call has any effect.
+      void setValue(T value)
+      {
+         complete([&] { m_value.emplace(std::move(value)); });
+      }
+
+      /// @brief set an exception as the result and resume any waiting coroutines. Only the first call has any effect.
+      void setException(std::exception_ptr exception)
+      {
+         complete([&] { m_exception = std::move(exception); });
+      }
+
+      auto operator co_await() noexcept
+      {
+         struct Awaiter
+         {
+            SharedResult& m_result;
+
+            auto await_ready() const -> bool 
+            { 
+               std::scoped_lock lock{ m_result.m_mutex };
+               return m_result.m_done; 
+            }
+
+            auto await_suspend(std::coroutine_handle<> handle) -> bool
+            {
+               std::scoped_lock lock{ m_result.m_mutex };
+               if (m_result.m_done)
+                  return false;   // finished since await_ready(), so don't suspend
+
+               m_result.m_waiters.push_back(handle);
+               return true;
+            }
+
+            auto await_resume() const -> T
+            {
+               // no lock needed, the result doesn't change once it's been set.
+               if (m_result.m_exception)
+                  std::rethrow_exception(m_result.m_exception);
+
+               return *m_result.m_value;
+            }
+         };
+         return Awaiter{ *this };
+      }
+
+      SharedResult() = default;
+      SharedResult(const SharedResult&) = delete;
+      SharedResult(SharedResult&&) = delete;
+      SharedResult& operator=(const SharedResult&) = delete;
+      SharedResult& operator=(SharedResult&&) = delete;
+      ~SharedResult() noexcept = default;
+
+   private:
+      std::mutex                           m_mutex{};
+      bool                                 m_done{ false };
+      std::optional<T>                     m_value{};
+      std::exception_ptr                   m_exception{};
+      std::vector<std::coroutine_handle<>> m_waiters{};
+
+      template<typename SetterT>
+      void complete(SetterT&& set_result)
+      {
+         std::vector<std::coroutine_handle<>> waiters{};
+         {
+            std::scoped_lock lock{ m_mutex };
+            if (m_done)
+               return;
+
+            set_result();
+            m_done = true;
+            waiters.swap(m_waiters);
+         }
+         for (auto handle : waiters)
+         {
+            handle.resume();
+         }
+      }
+   };
+
+
+   /// @brief awaitable that resumes the awaiting coroutine on one of the executor's worker threads
+   ///
+   /// If the executor cancels the continuation because it's shutting down, the co_await expression
+   /// throws a ctb::Error with category OperationCanceled.
+   ///
+   class ScheduleAwaiter
+   {
+   public:
+      ScheduleAwaiter(TaskExecutor& executor, TaskExecutor::Priority priority) noexcept : 
+         m_executor{ executor }, 
+         m_priority{ priority }
+      {}
+
+      auto await_ready() const noexcept -> bool { return false; }
+
+      void await_suspend(std::coroutine_handle<> handle)
+      {
+         m_executor.post(m_priority, [this, handle](std::stop_token token)
+            {
+               m_canceled = token.stop_requested();
+               handle.resume();
+            });
+      }
+
+      void await_resume() const
+      {
+         if (m_canceled)
+            throw Error{ constants::ERROR_STR_OPERATION_CANCELED, Error::Category::OperationCanceled };
+      }
+
+   private:
+      TaskExecutor&          m_executor;
+      TaskExecutor::Priority m_priority;
+      bool                   m_canceled{ false };
+   };
+
+
+   /// @brief co_await the return value to continue the current coroutine on an executor thread.
+   ///
+   /// @throws ctb::Error if the executor has been shut down
+   inline auto schedule(TaskExecutor& executor, TaskExecutor::Priority priority = TaskExecutor::Priority::Background) noexcept -> ScheduleAwaiter
+   {
+      return ScheduleAwaiter{ executor, priority };
+   }
+
+} // namespace ctb::tasks
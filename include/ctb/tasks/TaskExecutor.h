@@ -0,0 +1,163 @@
+/*********************************************************************
+ * @file       TaskExecutor.h
+ *
+ * @brief      declaration for the TaskExecutor class
+ *
+ * @copyright  Copyright © 2025 Jeff Kohn. All rights reserved.
+ *********************************************************************/
+#pragma once
+
+#include "ctb/ctb.h"
+#include "ctb/tasks/PollingTask.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+namespace ctb::tasks
+{
+
+   /// @brief fixed-size thread pool that runs tasks and returns them as PollingTask's.
+   ///
+   /// Tasks are queued in one of two lanes, idle workers always take Interactive tasks before Background tasks
+   /// so work the user is waiting on doesn't get stuck behind things like prefetching. Since the number of threads
+   /// is fixed, rapidly submitting requests (e.g. arrowing through a list) queues them up rather than creating a 
+   /// new thread for each one.
+   ///
+   /// If a task function takes a std::stop_token as its last parameter, it will be passed the executor's stop token
+   /// so it can exit early on shutdown. Tasks that haven't started when shutdown() is called will not run, their
+   /// PollingTask will return an OperationCanceled error.
+   ///
+   /// This class is thread-safe.
+   ///
+   class TaskExecutor final
+   {
+   public:
+      /// @brief task priorities, in the order workers will check for them
+      enum class Priority
+      {
+         Interactive,   // user is waiting on the result
+         Background     // speculative or housekeeping work
+      };
+
+      /// @brief construct the executor and start its worker threads
+      /// @param thread_count - number of worker threads. 0 uses the hardware concurrency, up to TASK_EXECUTOR_MAX_THREADS
+      explicit TaskExecutor(size_t thread_count = 0);
+
+      /// @brief shuts down the executor, see shutdown()
+      ~TaskExecutor() noexcept;
+
+      /// @brief queue a function to be run on a worker thread.
+      ///
+      /// func is called with args, plus the executor's stop_token if func accepts it as its final parameter.
+      /// 
+      /// @return a PollingTask that can be used to retrieve the result (or exception) from func
+      /// @throws ctb::Error if the executor has been shut down.
+      /// 
+      template<typename FuncT, typename... Args>
+      auto submit(Priority priority, FuncT&& func, Args&&... args) -> PollingTask<std::invoke_result_t<FuncT, Args..., std::stop_token>>
+         requires std::invocable<FuncT, Args..., std::stop_token>
+      {
+         using ReturnType = std::invoke_result_t<FuncT, Args..., std::stop_token>;
+         return submitImpl<ReturnType>(priority, [func = std::forward<FuncT>(func), ...args = std::forward<Args>(args)](std::stop_token token) mutable
+            {
+               return std::invoke(std::move(func), std::move(args)..., std::move(token));
+            });
+      }
+
+      template<typename FuncT, typename... Args>
+      auto submit(Priority priority, FuncT&& func, Args&&... args) -> PollingTask<std::invoke_result_t<FuncT, Args...>>
+         requires (std::invocable<FuncT, Args...> and not std::invocable<FuncT, Args..., std::stop_token>)
+      {
+         using ReturnType = std::invoke_result_t<FuncT, Args...>;
+         return submitImpl<ReturnType>(priority, [func = std::forward<FuncT>(func), ...args = std::forward<Args>(args)](std::stop_token) mutable
+            {
+               return std::invoke(std::move(func), std::move(args)...);
+            });
+      }
+
+      /// @brief type-erased queue entry. It's called with a stop_token that's already been triggered if the 
+      ///        job is being canceled without running, so it can clean up or report the cancellation.
+      using Job = std::move_only_function<void(std::stop_token)>;
+
+      /// @brief queue a job to be run on a worker thread, without any result handling.
+      ///
+      /// This is the building block for submit() and for resuming coroutines (see CoTask.h). Job's should
+      /// not throw, any exception will terminate the worker thread.
+      /// 
+      /// @throws ctb::Error if the executor has been shut down.
+      void post(Priority priority, Job&& job) noexcept(false);
+
+      /// @brief returns the number of tasks waiting for a worker thread
+      auto pendingCount() const -> size_t;
+
+      /// @brief returns the number of worker threads
+      auto threadCount() const noexcept -> size_t { return m_workers.size(); }
+
+      /// @brief signal cancellation to running tasks, cancel queued tasks, and join the worker threads. 
+      ///
+      /// This will block until running tasks have finished. Calling submit() after shutdown() will throw. 
+      /// Calling shutdown() more than once is harmless. 
+      /// 
+      void shutdown() noexcept;
+
+      TaskExecutor(const TaskExecutor&) = delete;
+      TaskExecutor(TaskExecutor&&) = delete;
+      TaskExecutor& operator=(const TaskExecutor&) = delete;
+      TaskExecutor& operator=(TaskExecutor&&) = delete;
+
+   private:
+      using Queue = std::deque<Job>;
+
+      mutable std::mutex          m_mutex{};
+      std::condition_variable_any m_wakeup{};
+      Queue                       m_interactive{};
+      Queue                       m_background{};
+      bool                        m_shut_down{ false };
+      std::vector<std::jthread>   m_workers{};
+
+      template<typename ReturnType, typename TaskT>
+      auto submitImpl(Priority priority, TaskT&& task) -> PollingTask<ReturnType>
+      {
+         std::promise<ReturnType> promise{};
+         auto future = promise.get_future();
+
+         post(priority, [task = std::forward<TaskT>(task), promise = std::move(promise)](std::stop_token token) mutable
+            {
+               try
+               {
+                  if (token.stop_requested())
+                     throw Error{ constants::ERROR_STR_OPERATION_CANCELED, Error::Category::OperationCanceled };
+
+                  if constexpr (std::is_void_v<ReturnType>)
+                  {
+                     task(std::move(token));
+                     promise.set_value();
+                  }
+                  else {
+                     promise.set_value(task(std::move(token)));
+                  }
+               }
+               catch (...) {
+                  promise.set_exception(std::current_exception());
+               }
+            });
+
+         return PollingTask<ReturnType>{ std::move(future) };
+      }
+
+      void run(std::stop_token token);
+   };
+
+
+   using TaskExecutorPtr = std::shared_ptr<TaskExecutor>;
+
+} // namespace ctb::tasks
@@ -10,7 +10,9 @@
 
 #include "ctb/ctb.h"
 #include "ctb/utility_http.h"
+#include "ctb/tasks/CoTask.h"
 #include "ctb/tasks/PollingTask.h"
+#include "ctb/tasks/TaskExecutor.h"
 
 #include <cpr/api.h>
 #include <cpr/cprtypes.h>
@@ -88,4 +90,33 @@ namespace ctb::tasks
    /// 
    auto runLabelDownloadTask(uint64_t wine_id, std::stop_token token = {}) noexcept(false) -> FetchFileTask::ReturnType;
 
+
+   /// @brief coroutine to load a binary file from disk into a buffer on an executor thread.
+   /// @param executor - executor to run the file I/O on, must remain valid until the coroutine completes
+   /// @param file - path of the file to read
+   /// @param priority - executor priority for the file I/O
+   /// @param token - cancellation support
+   /// @return the requested file bytes
+   /// @throws ctb::Error if the operation fails
+   /// 
+   auto loadFileAsync(TaskExecutorPtr executor, fs::path file, TaskExecutor::Priority priority, std::stop_token token = {}) -> CoTask<Buffer>;
+
+
+   /// @brief coroutine to run a HTTP GET request for the specified URL on an executor thread.
+   /// @param executor - executor to run the request on
+   /// @param url - url for the request
+   /// @param priority - executor priority for the request
+   /// @param token - cancellation support
+   /// @param args - variadic args to pass to the cpr request
+   /// @return the HTTP response returned by the request
+   /// @throws ctb::Error if the operation fails
+   /// 
+   template<typename... CprArgs>
+   auto httpGetAsync(TaskExecutorPtr executor, std::string url, TaskExecutor::Priority priority, std::stop_token token, CprArgs... args) -> CoTask<HttpRequestResult>
+   {
+      checkStopToken(token);
+      co_await schedule(*executor, priority);
+      co_return runHttpGetTask(std::move(url), token, std::move(args)...);
+   }
+
 } // namespace ctb::tasks
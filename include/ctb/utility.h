@@ -57,22 +57,35 @@ namespace ctb
 
    /// @brief convert text to UTF8 from other narrow/multi-byte encoding.
    ///
-   /// see https://learn.microsoft.com/en-us/windows/win32/Intl/code-page-identifiers
+   /// CP_WINDOWS_1252 and CP_ISO_LATIN_1 are converted directly on all platforms. On Windows, 
+   /// other code pages are converted using the Win32 API. See 
+   /// https://learn.microsoft.com/en-us/windows/win32/Intl/code-page-identifiers
    /// for a list of code page id's.
    /// 
    /// @return the converting string if successful, std::nullopt if not.
    /// 
-   [[nodiscard]] auto toUTF8(const std::string& text, unsigned int from_code_page = CP_WINDOWS_1252) -> MaybeString;
+   [[nodiscard]] auto toUTF8(std::string_view text, unsigned int from_code_page = CP_WINDOWS_1252) -> MaybeString;
 
 
-   /// @brief convert text to UTF8 from other narrow/multi-byte encoding.
+   /// @brief convert text to UTF8 from other narrow/multi-byte encoding, appending the result to dest.
    ///
-   /// see https://learn.microsoft.com/en-us/windows/win32/Intl/code-page-identifiers
-   /// for a list of code page id's.
+   /// This is useful for converting a stream of data in chunks, since dest can be reused without 
+   /// reallocating. Only works for single-byte code pages (e.g. a chunk boundary can't split a character).
    /// 
-   /// @return the converting string if successful, std::nullopt if not.
+   /// @return true if successful, false if not (dest may contain partial output in that case).
+   /// 
+   [[nodiscard]] auto appendUTF8(std::string_view text, std::string& dest, unsigned int from_code_page = CP_WINDOWS_1252) -> bool;
+
+
+   /// @brief convert text from UTF8 to other narrow/multi-byte encoding.
+   ///
+   /// CP_WINDOWS_1252 and CP_ISO_LATIN_1 are converted directly on all platforms. On Windows, 
+   /// other code pages are converted using the Win32 API. Characters that can't be represented 
+   /// in the target code page are replaced with '?'.
+   /// 
+   /// @return the converting string if successful, std::nullopt if not (e.g. utf8_text isn't valid UTF-8).
    /// 
-   [[nodiscard]] auto fromUTF8(const std::string& utf8_text, unsigned int to_code_page = CP_WINDOWS_1252) -> MaybeString;
+   [[nodiscard]] auto fromUTF8(std::string_view utf8_text, unsigned int to_code_page = CP_WINDOWS_1252) -> MaybeString;
 
 
    /// @brief  Expand environment variables in place
@@ -36,6 +36,11 @@ namespace ctb
       inline constexpr const char* ACCEPT_LANG_KEY        = "accept-language";
       inline constexpr const char* ACCEPT_LANG_VAL        = "en-US,en;q=0.9";
 
+      inline constexpr const char* ETAG_KEY               = "etag";
+      inline constexpr const char* IF_MODIFIED_SINCE_KEY  = "if-modified-since";
+      inline constexpr const char* IF_NONE_MATCH_KEY      = "if-none-match";
+      inline constexpr const char* LAST_MODIFIED_KEY      = "last-modified";
+
       inline constexpr const char* CACHE_CONTROL_KEY      = "cache-control";
       inline constexpr const char* NO_CACHE               = "no-cache";
 
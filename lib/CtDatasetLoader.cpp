@@ -8,6 +8,7 @@
 
 #include "ctb/model/CtDatasetLoader.h"
 #include "ctb/model/CtDataset.h"
+#include "ctb/LruCache.h"
 
 #include "ctb/tables/ConsumedWineTraits.h"
 #include "ctb/tables/PendingWineTraits.h"
@@ -20,6 +21,18 @@
 #include <magic_enum/magic_enum.hpp>
 #include <magic_enum/magic_enum_switch.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
 
 namespace ctb
 {
@@ -28,56 +41,341 @@ namespace ctb
 
    namespace
    {
+      using DatasetFactory = std::function<DatasetPtr()>;
+
+      /// @brief identifies a specific version of a table file, so we can tell if a cached table is stale
+      struct TableFileId
+      {
+         uintmax_t          file_size{};
+         fs::file_time_type last_write{};
+
+         auto operator==(const TableFileId&) const -> bool = default;
+      };
+
+      /// @brief a parsed table that's kept in memory, and a factory for creating datasets that share it
+      struct CachedTable
+      {
+         TableFileId    file_id{};
+         DatasetFactory make_dataset{};
+      };
+
+      /// @brief cache of the most recently loaded tables, keyed by file path. 
+      ///
+      /// This is shared by all loader instances, since callers typically create a loader each time 
+      /// they need a dataset.
+      auto tableCache() -> LruCache<std::string, CachedTable>&
+      {
+         static LruCache<std::string, CachedTable> cache{ constants::DATASET_CACHE_MAX_TABLES, [](const CachedTable&) -> size_t { return 1; } };
+         return cache;
+      }
+
+      /// @brief a table that's currently being loaded, so other requests for the same file can wait for it
+      struct InFlightLoad
+      {
+         std::optional<TableFileId>         file_id{};
+         std::shared_future<DatasetFactory> factory{};
+      };
+
+      /// @brief tables currently being loaded, keyed by file path like the table cache
+      struct InFlightLoads
+      {
+         std::mutex mutex{};
+         std::unordered_map<std::string, InFlightLoad> loads{};
+      };
+
+      auto inFlightLoads() -> InFlightLoads&
+      {
+         static InFlightLoads in_flight{};
+         return in_flight;
+      }
+
+      /// @return the identity of the specified table file, or std::nullopt if it can't be determined
+      auto getTableFileId(const fs::path& table_path) -> std::optional<TableFileId>
+      {
+         std::error_code ec{};
+         auto file_size = fs::file_size(table_path, ec);
+         if (ec)
+            return std::nullopt;
+
+         auto last_write = fs::last_write_time(table_path, ec);
+         if (ec)
+            return std::nullopt;
+
+         return TableFileId{ file_size, last_write };
+      }
+
+
       template<typename TableT>
-      auto getOrThrow(const fs::path& folder, TableId tbl_id) -> DatasetPtr
+      auto makeDatasetFactory(std::expected<TableT, Error> result) -> DatasetFactory
       {
-         auto result = loadTableData<TableT>(folder, tbl_id);
          if (!result)
-				throw result.error();
+            throw result.error();
 
-			return CtDataset<TableT>::create(std::move(result.value()));
+         // the table is immutable once loaded, so every dataset created by the factory can share it.
+         auto data = std::make_shared<const TableT>(std::move(result.value()));
+         return [data = std::move(data)]{ return CtDataset<TableT>::create(data); };
+      }
+
+      /// @brief overload for a table that might not have been loaded, returns an empty factory if it wasn't
+      template<typename TableT>
+      auto makeDatasetFactory(std::expected<std::optional<TableT>, Error> result) -> DatasetFactory
+      {
+         if (!result)
+            throw result.error();
+
+         if (not result->has_value())
+            return {};
+
+         return makeDatasetFactory(std::expected<TableT, Error>{ std::move(**result) });
+      }
+
+      /// @brief creates a dataset factory for the requested table, using the supplied function to get the table data.
+      ///
+      /// load is a generic lambda that's called with the table type as a template parameter, e.g. load<WineListTable>(tbl),
+      /// and must return std::expected<TableT, Error> or std::expected<std::optional<TableT>, Error>
+      template<typename LoadFuncT>
+      auto createDatasetFactory(TableId tbl, LoadFuncT&& load) -> DatasetFactory
+      {
+         Overloaded TableFactory{
+            [&load](enum_constant<TableId::List> tbl_id) -> DatasetFactory
+               { 
+                  return makeDatasetFactory(load.template operator()<WineListTable>(tbl_id));
+               },
+
+            [&load](enum_constant<TableId::Pending> tbl_id) -> DatasetFactory
+               { 
+                  return makeDatasetFactory(load.template operator()<PendingWineTable>(tbl_id));
+               },
+
+            [&load](enum_constant<TableId::Consumed> tbl_id) -> DatasetFactory
+               { 
+                  return makeDatasetFactory(load.template operator()<ConsumedWineTable>(tbl_id));
+               },
+
+            [&load](enum_constant<TableId::Availability> tbl_id) -> DatasetFactory
+               { 
+                  return makeDatasetFactory(load.template operator()<ReadyToDrinkTable>(tbl_id));
+               },
+
+            [&load](enum_constant<TableId::Purchase> tbl_id) -> DatasetFactory
+               { 
+                  return makeDatasetFactory(load.template operator()<PurchasedWineTable>(tbl_id));
+               },
+
+            [&load](enum_constant<TableId::Tag> tbl_id) -> DatasetFactory
+               { 
+                  return makeDatasetFactory(load.template operator()<TaggedWinesTable>(tbl_id));
+               },
+
+            [&load](enum_constant<TableId::Notes> tbl_id) -> DatasetFactory
+               { 
+                  return makeDatasetFactory(load.template operator()<TastingNotesTable>(tbl_id));
+               }
+         };
+         return enum_switch(TableFactory, tbl);
+      }
+
+      /// @brief adds a table to the cache, if we can identify the file it was loaded from
+      void cacheTable(const fs::path& table_path, std::optional<TableFileId> file_id, const DatasetFactory& factory)
+      {
+         if (file_id)
+         {
+            tableCache().put(table_path.generic_string(), CachedTable{ *file_id, factory });
+         }
+      }
+
+      /// @brief returns the cached table if the file hasn't changed since it was loaded, std::nullopt otherwise
+      auto getCachedTable(const fs::path& table_path, const std::optional<TableFileId>& file_id) -> std::optional<CachedTable>
+      {
+         auto cached = tableCache().get(table_path.generic_string());
+         if (cached and file_id and cached->file_id == *file_id)
+            return cached;
+
+         return std::nullopt;
+      }
+
+      /// @brief returns true if the table is in the cache and its file hasn't changed since it was loaded
+      auto isTableCached(const fs::path& data_folder, TableId tbl) -> bool
+      {
+         auto table_path = getTablePath(data_folder, tbl, DataFormatId::csv);
+         return getCachedTable(table_path, getTableFileId(table_path)).has_value();
+      }
+
+      /// @brief tables waiting to be preloaded, shared by the jobs loading them
+      struct PreloadQueue
+      {
+         fs::path              data_folder{};
+         std::vector<TableId>  tables{};
+         std::atomic<size_t>   next{};
+      };
+      using PreloadQueuePtr = std::shared_ptr<PreloadQueue>;
+
+      auto getDatasetFactory(const fs::path& data_folder, TableId tbl) -> DatasetFactory;
+
+      /// @brief post a job that preloads the next table in the queue, and then posts another job for the one after it.
+      void postNextPreload(tasks::TaskExecutor& executor, PreloadQueuePtr queue, std::stop_token token)
+      {
+         using Priority = tasks::TaskExecutor::Priority;
+
+         executor.post(Priority::Background, [&executor, queue, token](std::stop_token executor_token)
+            {
+               // the stop check is all we can do, there's no way to interrupt a table that's already being parsed.
+               auto idx = queue->next.fetch_add(1);
+               if (idx >= queue->tables.size() or token.stop_requested() or executor_token.stop_requested())
+                  return;
+
+               auto tbl = queue->tables[idx];
+               try
+               {
+                  getDatasetFactory(queue->data_folder, tbl);
+               }
+               catch(...){
+                  log::warn("Preloading table '{}' failed. {}", getTableDescription(tbl), packageError().formattedMesage());
+               }
+
+               try
+               {
+                  if (idx + 1 < queue->tables.size())
+                     postNextPreload(executor, queue, token);
+               }
+               catch(...){
+                  // the executor is shutting down
+                  log::info("Preloading stopped. {}", packageError().formattedMesage());
+               }
+            });
+      }
+
+      /// @brief returns a dataset factory for the table, loading and caching it if it's not already cached
+      ///
+      /// If the same version of the table is already being loaded (e.g. by preloadTables()), this waits for 
+      /// that load instead of parsing the file again.
+      auto getDatasetFactory(const fs::path& data_folder, TableId tbl) -> DatasetFactory
+      {
+         auto table_path = getTablePath(data_folder, tbl, DataFormatId::csv);
+         auto file_id = getTableFileId(table_path);
+         if (auto cached = getCachedTable(table_path, file_id))
+         {
+            return cached->make_dataset;
+         }
+
+         auto key = table_path.generic_string();
+         auto& in_flight = inFlightLoads();
+         std::promise<DatasetFactory> promise{};
+         std::shared_future<DatasetFactory> pending{};
+         {
+            std::scoped_lock lock{ in_flight.mutex };
+
+            // a load may have finished since we checked the cache
+            if (auto cached = getCachedTable(table_path, file_id))
+               return cached->make_dataset;
+
+            if (auto it = in_flight.loads.find(key); it != in_flight.loads.end() and it->second.file_id == file_id)
+            {
+               pending = it->second.factory;
+            }
+            else {
+               in_flight.loads[key] = InFlightLoad{ file_id, promise.get_future().share() };
+            }
+         }
+
+         // get() rethrows the error if that load failed
+         if (pending.valid())
+            return pending.get();
+
+         // the load is removed from the in-flight list after it's cached (or failed), so nobody can miss both.
+         auto finishLoad = [&]
+            {
+               std::scoped_lock lock{ in_flight.mutex };
+               if (auto it = in_flight.loads.find(key); it != in_flight.loads.end() and it->second.file_id == file_id)
+                  in_flight.loads.erase(it);
+            };
+
+         try
+         {
+            auto factory = createDatasetFactory(tbl, [&data_folder]<typename TableT>(TableId tbl_id)
+               {
+                  return loadTableData<TableT>(data_folder, tbl_id);
+               });
+
+            // file_id was retrieved before loading, so if the file changed while we were reading it, the 
+            // cache entry will be considered stale next time.
+            cacheTable(table_path, file_id, factory);
+            finishLoad();
+            promise.set_value(factory);
+            return factory;
+         }
+         catch (...)
+         {
+            finishLoad();
+            promise.set_exception(std::current_exception());
+            throw;
+         }
       }
    }
 
+
    auto CtDatasetLoader::getDataset(TableId tbl) -> DatasetPtr
    {
-      Overloaded TableFactory{
-         [this](enum_constant<TableId::List> tbl_id)  -> DatasetPtr
-            { 
-					return getOrThrow<WineListTable>(m_data_folder, tbl_id);
-            },
-
-         [this](enum_constant<TableId::Pending> tbl_id) -> DatasetPtr
-            { 
-               return getOrThrow<PendingWineTable>(m_data_folder, tbl_id);
-            }, 
-
-         [this](enum_constant<TableId::Consumed> tbl_id) -> DatasetPtr
-            { 
-               return getOrThrow<ConsumedWineTable>(m_data_folder, tbl_id);
-            }, 
-
-         [this](enum_constant<TableId::Availability> tbl_id) -> DatasetPtr
-            { 
-               return getOrThrow<ReadyToDrinkTable>(m_data_folder, tbl_id);
-            },
-
-         [this](enum_constant<TableId::Purchase> tbl_id) -> DatasetPtr
-            {
-               return getOrThrow<PurchasedWineTable>(m_data_folder, tbl_id);
-            },
+      return getDatasetFactory(m_data_folder, tbl)();
+   }
+
 
-         [this](enum_constant<TableId::Tag> tbl_id) -> DatasetPtr
+   auto CtDatasetLoader::preloadTables(tasks::TaskExecutor& executor, std::stop_token token) -> size_t
+   {
+      auto queue = std::make_shared<PreloadQueue>();
+      queue->data_folder = m_data_folder;
+      for (auto tbl : getAvailableTables(m_data_folder))
+      {
+         if (!isTableCached(m_data_folder, tbl))
+            queue->tables.push_back(tbl);
+      }
+
+      // running jobs can't be preempted, so we leave a worker free for interactive tasks (e.g. label fetches). 
+      // Each lane loads tables one at a time, posting the next load when the previous one finishes.
+      auto lanes = std::min(queue->tables.size(), std::max<size_t>(executor.threadCount(), 2) - 1);
+      for (size_t lane = 0; lane < lanes; ++lane)
+      {
+         postNextPreload(executor, queue, token);
+      }
+      return queue->tables.size();
+   }
+
+
+   auto CtDatasetLoader::downloadTables(const CredentialWrapper& cred, std::span<const TableId> tables, std::stop_token token, 
+                                        ProgressCallback* callback) -> TableSyncResults
+   {
+      TableDownloadFunc download_and_parse = [](const CredentialWrapper& cred, TableId tbl, [[maybe_unused]] DataFormatId format, 
+                                                const fs::path& table_path, ProgressCallback* table_callback) -> TableFileResult
+         {
+            try
             {
-               return getOrThrow<TaggedWinesTable>(m_data_folder, tbl_id);
-            },
+               auto factory = createDatasetFactory(tbl, [&cred, &table_path, table_callback]<typename TableT>(TableId tbl_id)
+                  {
+                     return downloadTableData<TableT>(cred, tbl_id, table_path, table_callback);
+                  });
 
-         [this](enum_constant<TableId::Notes> tbl_id) -> DatasetPtr
+               // no factory means the table hasn't changed, so any cached version is still current
+               if (!factory)
+                  return false;
+
+               // the file has already been renamed into place, so this identifies the version we just parsed.
+               cacheTable(table_path, getTableFileId(table_path), factory);
+               return true;
+            }
+            catch (...)
             {
-               return getOrThrow<TastingNotesTable>(m_data_folder, tbl_id);
+               return std::unexpected{ packageError() };
             }
-      };
-      return enum_switch(TableFactory, tbl);
+         };
+
+      return ctb::downloadTables(cred, tables, DataFormatId::csv, m_data_folder, token, callback, download_and_parse);
+   }
+
+
+   void CtDatasetLoader::clearCache()
+   {
+      tableCache().clear();
    }
 
-}  // ctb
\ No newline at end of file
+
+}  // ctb
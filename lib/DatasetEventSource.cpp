@@ -8,6 +8,10 @@
 
 #include "ctb/model/DatasetEventSource.h"
 
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
 
 namespace ctb
 {
@@ -20,6 +24,20 @@ namespace ctb
    }
 
 
+   [[nodiscard]] 
+   auto DatasetEventSource::create(DeferFunc defer) -> DatasetEventSourcePtr
+   {
+      if (!defer)
+      {
+         assert("defer func cannot be empty" and false);
+         throw Error{ Error::Category::ArgumentError, constants::ERROR_STR_NULLPTR_ARG };
+      }
+      auto source = std::shared_ptr<DatasetEventSource>{ new DatasetEventSource{} };
+      source->m_defer = std::move(defer);
+      return source;
+   }
+
+
    auto DatasetEventSource::hasDataset() const  noexcept-> bool
    { 
       return m_data ? true : false; 
@@ -59,6 +77,14 @@ namespace ctb
    {
       SPDLOG_DEBUG("DatasetEventSource::detach() called.");
       m_observers.erase(observer);
+
+      // a queued event excluding this observer is now just a regular event, and we don't want to 
+      // hang on to a pointer that may soon be dangling.
+      for (auto& pending : m_pending)
+      {
+         if (pending.event_source == observer)
+            pending.event_source = nullptr;
+      }
    }
 
 
@@ -67,6 +93,96 @@ namespace ctb
       [[maybe_unused]] auto event_name = magic_enum::enum_name(event_id);
       SPDLOG_DEBUG("DatasetEventSource::signal({},{}) called", event_name, rec_idx.value_or(-1));
 
+      if (event_id == DatasetEvent::Id::DatasetRemove or event_id == DatasetEvent::Id::DatasetInitialize)
+      {
+         // anything still queued refers to the dataset being removed/re-initialized, so it's moot.
+         m_pending.clear();
+         return dispatch(event_id, rec_idx, event_source);
+      }
+
+      if (isCoalescing())
+         return enqueue(event_id, rec_idx, event_source);
+
+      return dispatch(event_id, rec_idx, event_source);
+   }
+
+
+   auto DatasetEventSource::enqueue(DatasetEvent::Id event_id, NullableInt rec_idx, IDatasetEventSink* event_source) noexcept -> bool
+   {
+      if (!m_data)
+         return true;
+
+      // a later event of the same type supersedes an earlier one, but keep the latest row index since
+      // that reflects the current state of the dataset.
+      auto it = rng::find_if(m_pending, [&](const PendingEvent& pending)
+         {
+            return pending.event_id == event_id and pending.event_source == event_source;
+         });
+
+      try
+      {
+         if (it != m_pending.end())
+         {
+            it->rec_idx = rec_idx;
+         }
+         else {
+            m_pending.emplace_back(event_id, rec_idx, event_source);
+         }
+      }
+      catch(...){
+         // if we can't queue the event, dispatching it now is better than losing it.
+         log::exception(packageError());
+         return dispatch(event_id, rec_idx, event_source);
+      }
+
+      if (!m_flush_scheduled)
+      {
+         try
+         {
+            m_defer([weak_self = weak_from_this()]
+               {
+                  if (auto self = weak_self.lock())
+                     self->flush();
+               });
+            m_flush_scheduled = true;
+         }
+         catch(...){
+            log::exception(packageError());
+            return flush();
+         }
+      }
+      return true;
+   }
+
+
+   auto DatasetEventSource::flush() noexcept -> bool
+   {
+      // reset state before dispatching, so any events signaled by observers during the flush get 
+      // queued for the next one.
+      auto pending = std::exchange(m_pending, {});
+      m_flush_scheduled = false;
+
+      rng::stable_sort(pending, {}, [](const PendingEvent& event) { return dispatchRank(event.event_id); });
+
+      bool retval{ true };
+      auto dataset = m_data;
+      for (const auto& event : pending)
+      {
+         // an observer may have replaced the dataset, in which case the rest of these events are moot.
+         if (m_data != dataset)
+            break;
+
+         if (!dispatch(event.event_id, event.rec_idx, event.event_source))
+            retval = false;
+      }
+      return retval;
+   }
+
+
+   auto DatasetEventSource::dispatch(DatasetEvent::Id event_id, NullableInt rec_idx, IDatasetEventSink* event_source) noexcept -> bool
+   {
+      [[maybe_unused]] auto event_name = magic_enum::enum_name(event_id);
+
       bool retval{ true };
       if (m_data)
       {
@@ -74,7 +190,7 @@ namespace ctb
          { 
             try
             {
-               if (observer != event_source)
+               if (observer != event_source and observer->wantsEvent(event_id))
                {
                   observer->notify({ event_id, m_data, rec_idx });
                }
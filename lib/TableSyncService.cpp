@@ -0,0 +1,126 @@
+/*********************************************************************
+ * @file       TableSyncService.cpp
+ *
+ * @brief      Implementation for the class TableSyncService
+ *
+ * @copyright  Copyright © 2025 Jeff Kohn. All rights reserved.
+ *********************************************************************/
+#include "ctb/TableSyncService.h"
+#include "ctb/model/CtDatasetLoader.h"
+#include "ctb/log.h"
+
+
+namespace ctb
+{
+
+   TableSyncService::TableSyncService(CredentialWrapper&& cred, fs::path data_folder, SyncCallback on_sync) :
+      m_cred{ std::move(cred) },
+      m_data_folder{ std::move(data_folder) },
+      m_on_sync{ std::move(on_sync) },
+      m_worker{ [this](std::stop_token token) { run(token); } }
+   {}
+
+
+   TableSyncService::~TableSyncService() noexcept
+   {
+      // jthread's destructor would do this too, but we want the worker gone before any other members are destroyed.
+      m_worker.request_stop();
+      if (m_worker.joinable())
+         m_worker.join();
+   }
+
+
+   void TableSyncService::setSchedule(TableId tbl, Interval interval)
+   {
+      {
+         std::lock_guard lock{ m_mutex };
+         auto& schedule = m_schedule[tbl];
+         schedule.interval = interval;
+         schedule.next_due = interval.count() > 0 ? Clock::now() + interval : Clock::time_point::max();
+      }
+      m_wakeup.notify_one();
+   }
+
+
+   void TableSyncService::removeSchedule(TableId tbl)
+   {
+      std::lock_guard lock{ m_mutex };
+      m_schedule.erase(tbl);
+   }
+
+
+   void TableSyncService::syncNow()
+   {
+      {
+         std::lock_guard lock{ m_mutex };
+         m_sync_now = true;
+      }
+      m_wakeup.notify_one();
+   }
+
+
+   auto TableSyncService::nextDue() const -> Clock::time_point
+   {
+      if (m_schedule.empty())
+         return Clock::time_point::max();
+
+      return rng::min(m_schedule | vws::values | vws::transform(&Schedule::next_due));
+   }
+
+
+   auto TableSyncService::takeDueTables() -> std::vector<TableId>
+   {
+      // caller must hold m_mutex
+      auto now = Clock::now();
+      std::vector<TableId> tables{};
+      for (auto& [tbl, schedule] : m_schedule)
+      {
+         if (m_sync_now or schedule.next_due <= now)
+         {
+            tables.push_back(tbl);
+            schedule.next_due = schedule.interval.count() > 0 ? now + schedule.interval : Clock::time_point::max();
+         }
+      }
+      m_sync_now = false;
+      return tables;
+   }
+
+
+   void TableSyncService::run(std::stop_token token)
+   {
+      while (not token.stop_requested())
+      {
+         std::vector<TableId> tables{};
+         {
+            std::unique_lock lock{ m_mutex };
+
+            // the wait returns early if stop is requested, in which case the predicate is false. We also wake
+            // up if a table is scheduled sooner than the one we're waiting for, so we can recalculate the deadline.
+            auto next_due = nextDue();
+            auto isReady = [this, next_due] { return m_sync_now or nextDue() <= Clock::now() or nextDue() < next_due; };
+            bool ready = next_due == Clock::time_point::max() ? m_wakeup.wait(lock, token, isReady)
+                                                              : m_wakeup.wait_until(lock, token, next_due, isReady);
+            if (!ready)
+               continue;
+
+            tables = takeDueTables();
+         }
+
+         if (tables.empty())
+            continue;
+
+         try
+         {
+            // tables are parsed as they download, so the UI can pick them up from the dataset cache.
+            auto results = CtDatasetLoader{ m_data_folder }.downloadTables(m_cred, tables, token);
+            if (not token.stop_requested())
+               m_on_sync(std::move(results));
+         }
+         catch (...) {
+            log::exception(packageError());
+         }
+      }
+   }
+
+
+} // namespace ctb
@@ -0,0 +1,99 @@
+/*********************************************************************
+ * @file       TaskExecutor.cpp
+ *
+ * @brief      implementation for the TaskExecutor class
+ *
+ * @copyright  Copyright © 2025 Jeff Kohn. All rights reserved.
+ *********************************************************************/
+
+#include "ctb/tasks/TaskExecutor.h"
+
+#include <algorithm>
+
+
+namespace ctb::tasks
+{
+
+   TaskExecutor::TaskExecutor(size_t thread_count)
+   {
+      if (thread_count == 0)
+         thread_count = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, constants::TASK_EXECUTOR_MAX_THREADS);
+
+      m_workers.reserve(thread_count);
+      for (size_t i = 0; i < thread_count; ++i)
+      {
+         m_workers.emplace_back([this](std::stop_token token) { run(token); });
+      }
+   }
+
+
+   TaskExecutor::~TaskExecutor() noexcept
+   {
+      shutdown();
+   }
+
+
+   auto TaskExecutor::pendingCount() const -> size_t
+   {
+      std::scoped_lock lock{ m_mutex };
+      return m_interactive.size() + m_background.size();
+   }
+
+
+   void TaskExecutor::shutdown() noexcept
+   {
+      {
+         std::scoped_lock lock{ m_mutex };
+         if (m_shut_down)
+            return;
+
+         m_shut_down = true;
+      }
+
+      // workers exit once the queues are empty, any tasks they dequeue after this get a stopped token
+      // so they're canceled rather than run.
+      for (auto& worker : m_workers)
+      {
+         worker.request_stop();
+      }
+      m_wakeup.notify_all();
+      m_workers.clear();   // joins
+   }
+
+
+   void TaskExecutor::post(Priority priority, Job&& job) noexcept(false)
+   {
+      {
+         std::scoped_lock lock{ m_mutex };
+         if (m_shut_down)
+            throw Error{ constants::ERROR_STR_OPERATION_CANCELED, Error::Category::OperationCanceled };
+
+         auto& queue = priority == Priority::Interactive ? m_interactive : m_background;
+         queue.push_back(std::move(job));
+      }
+      m_wakeup.notify_one();
+   }
+
+
+   void TaskExecutor::run(std::stop_token token)
+   {
+      while (true)
+      {
+         Job job{};
+         {
+            std::unique_lock lock{ m_mutex };
+            auto has_work = [this] { return !m_interactive.empty() or !m_background.empty(); };
+            if (!m_wakeup.wait(lock, token, has_work))
+               return; // stop requested and nothing left to cancel
+
+            auto& queue = m_interactive.empty() ? m_background : m_interactive;
+            job = std::move(queue.front());
+            queue.pop_front();
+         }
+
+         // jobs catch their own exceptions and store them in the PollingTask's future
+         job(token);
+      }
+   }
+
+} // namespace ctb::tasks
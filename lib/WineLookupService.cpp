@@ -0,0 +1,69 @@
+/*******************************************************************
+ * @file WineLookupService.cpp
+ *
+ * @brief Implementation file for the WineLookupService class
+ * 
+ * @copyright Copyright © 2025 Jeff Kohn. All rights reserved. 
+ *******************************************************************/
+
+#include "ctb/model/WineLookupService.h"
+#include "ctb/model/JoinedDataset.h"
+
+#include <magic_enum/magic_enum.hpp>
+
+#include <system_error>
+
+
+namespace ctb
+{
+
+   auto WineLookupService::findRecords(TableId tbl, uint64_t wine_id, const RecordVisitor& visitor) -> size_t
+   {
+      auto dataset = lookupDataset(tbl);
+      return dataset ? dataset->findWineRecords(wine_id, visitor) : 0;
+   }
+
+
+   auto WineLookupService::countRecords(uint64_t wine_id) -> std::map<TableId, size_t>
+   {
+      std::map<TableId, size_t> counts{};
+      for (auto tbl : getAvailableTables(m_loader.getDataFolder()))
+      {
+         if (auto count = findRecords(tbl, wine_id); count)
+         {
+            counts[tbl] = count;
+         }
+      }
+      return counts;
+   }
+
+
+   auto WineLookupService::createJoinedDataset(TableId primary, TableId secondary, CtListColumnSpan joined_columns) -> DatasetPtr
+   {
+      return JoinedDataset::create(m_loader.getDataset(primary), m_loader.getDataset(secondary), joined_columns);
+   }
+
+
+   auto WineLookupService::lookupDataset(TableId tbl) -> DatasetPtr
+   {
+      auto table_path = getTablePath(m_loader.getDataFolder(), tbl);
+
+      std::error_code ec{};
+      auto last_write = fs::last_write_time(table_path, ec);
+      if (ec)
+      {
+         // table isn't available (any more)
+         m_lookup_datasets.erase(tbl);
+         return {};
+      }
+
+      auto it = m_lookup_datasets.find(tbl);
+      if (it == m_lookup_datasets.end() or it->second.last_write != last_write)
+      {
+         SPDLOG_DEBUG("WineLookupService loading table {} for lookups", magic_enum::enum_name(tbl));
+         it = m_lookup_datasets.insert_or_assign(tbl, LookupDataset{ m_loader.getDataset(tbl), last_write }).first;
+      }
+      return it->second.dataset;
+   }
+
+} // namespace ctb
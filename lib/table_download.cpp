@@ -14,6 +14,10 @@
 #include <cpr/response.h>
 #include <cpr/status_codes.h>
 
+#include <charconv>
+#include <chrono>
+#include <fstream>
+
 namespace ctb
 {
    /// @brief  returns true if the request returned a valid response, or an Error if it didn't
@@ -59,24 +63,155 @@ namespace ctb
 } // anon namespace
 
 
+namespace
+{
+   using namespace ctb;
+
+   /// @brief cache validators from a previous download, saved next to the table file
+   struct TableValidators
+   {
+      std::string etag{};
+      std::string last_modified{};
+      uint64_t    content_hash{};
+   };
+
+   constexpr std::string_view VALIDATOR_ETAG          = "ETag";
+   constexpr std::string_view VALIDATOR_LAST_MODIFIED = "Last-Modified";
+   constexpr std::string_view VALIDATOR_CONTENT_HASH  = "Content-Hash";
+
+
+   auto getValidatorsPath(const fs::path& table_path) -> fs::path
+   {
+      auto path{ table_path };
+      path += constants::VALIDATORS_FILE_SUFFIX;
+      return path;
+   }
+
+
+   /// @brief load the validators for a table file. Returns empty validators if they're missing, or if the table file
+   ///        itself is missing (since there's nothing to validate against).
+   auto loadValidators(const fs::path& table_path) -> TableValidators
+   {
+      TableValidators validators{};
+      if (not fs::exists(table_path))
+         return validators;
+
+      std::ifstream file{ getValidatorsPath(table_path) };
+      for (std::string line{}; std::getline(file, line); )
+      {
+         auto pos = line.find('=');
+         if (pos == std::string::npos)
+            continue;
+
+         auto key = std::string_view{ line }.substr(0, pos);
+         auto val = line.substr(pos + 1);
+         if (key == VALIDATOR_ETAG)
+         {
+            validators.etag = std::move(val);
+         }
+         else if (key == VALIDATOR_LAST_MODIFIED)
+         {
+            validators.last_modified = std::move(val);
+         }
+         else if (key == VALIDATOR_CONTENT_HASH)
+         {
+            std::from_chars(val.data(), val.data() + val.size(), validators.content_hash);
+         }
+      }
+      return validators;
+   }
+
+
+   /// @brief save validators for a table file. Failure isn't an error, it just means the next download won't be conditional.
+   void saveValidators(const fs::path& table_path, const TableValidators& validators)
+   {
+      std::ofstream file{ getValidatorsPath(table_path), std::ios::trunc };
+      file << VALIDATOR_ETAG          << '=' << validators.etag          << '\n'
+           << VALIDATOR_LAST_MODIFIED << '=' << validators.last_modified << '\n'
+           << VALIDATOR_CONTENT_HASH  << '=' << validators.content_hash  << '\n';
+   }
+
+
+   /// @brief incremental FNV-1a hash, used to detect downloads that are identical to what we already have
+   class ContentHash
+   {
+   public:
+      void update(std::string_view data) noexcept
+      {
+         for (auto ch : data)
+         {
+            m_hash ^= static_cast<uint8_t>(ch);
+            m_hash *= Prime;
+         }
+      }
+
+      auto value() const noexcept -> uint64_t { return m_hash; }
+
+   private:
+      static constexpr uint64_t OffsetBasis = 14695981039346656037ull;
+      static constexpr uint64_t Prime       = 1099511628211ull;
+
+      uint64_t m_hash{ OffsetBasis };
+   };
+
+
+   /// @brief headers for a conditional request based on previously saved validators
+   auto getConditionalHeaders(const TableValidators& validators) -> cpr::Header
+   {
+      cpr::Header header{};
+      if (!validators.etag.empty())
+         header[headers::IF_NONE_MATCH_KEY] = validators.etag;
+
+      if (!validators.last_modified.empty())
+         header[headers::IF_MODIFIED_SINCE_KEY] = validators.last_modified;
+
+      return header;
+   }
+
+
+   /// @brief the URL for a table download, including the query parameters
+   auto getTableUrl(std::string_view base_url, const CredentialWrapper& cred, std::string_view format, std::string_view table) -> cpr::Url
+   {
+      return cpr::Url{ ctb::format(constants::FMT_URL_CT_TABLE, base_url, percentEncode(cred.username()), percentEncode(cred.password()), format, table) };
+   }
+
+
+   /// @brief limits for how long a table download can take. Tables can be large, so the overall timeout is generous, 
+   ///        it's just there so a stalled connection doesn't hang a sync forever.
+   auto getConnectTimeout() -> cpr::ConnectTimeout
+   {
+      return cpr::ConnectTimeout{ std::chrono::seconds{ constants::HTTP_TIMEOUT_SEC } };
+   }
+
+   auto getTimeout() -> cpr::Timeout
+   {
+      return cpr::Timeout{ std::chrono::seconds{ constants::HTTP_TABLE_TIMEOUT_SEC } };
+   }
+
+
+   /// @brief we ask for compressed responses, curl takes care of decompressing them
+   auto getAcceptEncoding() -> cpr::AcceptEncoding
+   {
+      return cpr::AcceptEncoding{ { cpr::AcceptEncodingMethods::gzip, cpr::AcceptEncodingMethods::deflate } };
+   }
+
+} // anon namespace
+
+
 namespace ctb
 {
 
 
    [[nodiscard]] auto downloadRawTableData(const CredentialWrapper& cred, TableId table,  DataFormatId format, ProgressCallback* callback, 
-                                           bool convert_to_utf, uint32_t table_code_page ) -> DownloadResult
+                                           bool convert_to_utf, uint32_t table_code_page, std::string_view base_url) -> DownloadResult
    {
       auto table_name = magic_enum::enum_name(table);
       auto data_format = magic_enum::enum_name(format);
 
-      cpr::Url url{ ctb::format(constants::FMT_URL_CT_TABLE,
-                                percentEncode(cred.username()),
-                                percentEncode(cred.password()),
-                                data_format, table_name)
-      };
+      auto url = getTableUrl(base_url, cred, data_format, table_name);
 
-      auto response = callback ? cpr::Get(url, *callback)
-                               : cpr::Get(url);
+      auto response = callback ? cpr::Get(url, getAcceptEncoding(), getConnectTimeout(), getTimeout(), *callback)
+                               : cpr::Get(url, getAcceptEncoding(), getConnectTimeout(), getTimeout());
 
       // check the response for success, bail out if we got an error 
       auto request_result = validateResponse(response);
@@ -100,4 +235,102 @@ namespace ctb
    }
 
 
+   [[nodiscard]] auto downloadTableFile(const CredentialWrapper& cred, TableId table, DataFormatId format, const fs::path& file_path, 
+                                        DownloadChunkCallback* chunk_callback, ProgressCallback* callback,
+                                        bool convert_to_utf, uint32_t table_code_page, std::string_view base_url) -> TableFileResult
+   {
+      auto url = getTableUrl(base_url, cred, magic_enum::enum_name(format), magic_enum::enum_name(table));
+
+      auto temp_path{ file_path };
+      temp_path.replace_extension(constants::DOWNLOAD_FILE_EXTENSION);
+
+      std::ofstream file{ temp_path, std::ios::binary | std::ios::trunc };
+      if (!file)
+         return std::unexpected{ Error{ Error::Category::FileError, constants::FMT_ERROR_FILE_OPEN_FAILED, temp_path.generic_string() } };
+
+      // CT returns a small HTML page instead of a file if the logon fails, so we keep the beginning of the 
+      // response around to check for that.
+      const auto logon_error_size = std::string_view{ constants::ERR_STR_INVALID_CELLARTRACKER_LOGON }.size();
+      std::string response_start{};
+
+      auto validators = loadValidators(file_path);
+      ContentHash content_hash{};
+      std::string converted{}; // reused for each chunk, to avoid reallocating
+
+      cpr::WriteCallback write_callback{ [&](std::string_view data, [[maybe_unused]] intptr_t userdata) -> bool
+         {
+            if (response_start.size() <= logon_error_size)
+               response_start.append(data.substr(0, logon_error_size + 1 - response_start.size()));
+
+            if (convert_to_utf)
+            {
+               // Windows-1252 is a single-byte encoding, so each chunk can be converted independently. 
+               // If the conversion fails, just use the original encoding as fallback.
+               converted.clear();
+               if (appendUTF8(data, converted, table_code_page))
+               {
+                  data = converted;
+               }
+            }
+
+            content_hash.update(data);
+            file.write(data.data(), std::ssize(data));
+            if (!file)
+               return false;
+
+            return chunk_callback ? (*chunk_callback)(data) : true;
+         }};
+
+      auto response = callback ? cpr::Get(url, write_callback, getConditionalHeaders(validators), getAcceptEncoding(), getConnectTimeout(), getTimeout(), *callback)
+                               : cpr::Get(url, write_callback, getConditionalHeaders(validators), getAcceptEncoding(), getConnectTimeout(), getTimeout());
+      file.close();
+
+      std::error_code ec{};
+      if (response.status_code == std::to_underlying(HttpStatus::Code::NotModified))
+      {
+         fs::remove(temp_path, ec);
+         return false;
+      }
+
+      // body went to the file, validation only needs the beginning of it. A write failure
+      // also aborts the request, so check for that first to report the right error.
+      response.text = std::move(response_start);
+      auto request_result = validateResponse(response);
+      if (file.fail())
+      {
+         request_result = std::unexpected{ Error{ Error::Category::FileError, constants::FMT_ERROR_FILE_WRITE_FAILED, temp_path.generic_string() } };
+      }
+
+      if (!request_result.has_value())
+      {
+         fs::remove(temp_path, ec);
+         return std::unexpected{ request_result.error() };
+      }
+
+      // not every server honors conditional requests, so also check whether we got the same content we already have.
+      bool changed = validators.content_hash != content_hash.value();
+      validators.etag          = response.header[headers::ETAG_KEY];
+      validators.last_modified = response.header[headers::LAST_MODIFIED_KEY];
+      validators.content_hash  = content_hash.value();
+
+      if (not changed)
+      {
+         fs::remove(temp_path, ec);
+         saveValidators(file_path, validators);
+         return false;
+      }
+
+      // rename is atomic when source and destination are on the same volume, so readers will see either 
+      // the old file or the new one, never a partial download.
+      fs::rename(temp_path, file_path, ec);
+      if (ec)
+      {
+         fs::remove(temp_path, ec);
+         return std::unexpected{ Error{ ec.value(), ec.message(), Error::Category::FileError } };
+      }
+      saveValidators(file_path, validators);
+      return true;
+   }
+
+
 } // namespace ctb
\ No newline at end of file
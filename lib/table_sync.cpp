@@ -0,0 +1,130 @@
+/*********************************************************************
+ * @file       table_sync.cpp
+ *
+ * @brief      implements concurrent download of CT tables
+ *
+ * @copyright  Copyright © 2025 Jeff Kohn. All rights reserved.
+ *********************************************************************/
+#include "ctb/table_sync.h"
+#include "external/HttpStatusCodes.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+namespace ctb
+{
+   namespace
+   {
+      /// @brief progress for a single download, written by a worker thread and read by the calling thread
+      struct DownloadProgress
+      {
+         std::atomic<int64_t> download_total{};
+         std::atomic<int64_t> download_now{};
+      };
+
+      auto canceledResult() -> TableFileResult
+      {
+         return std::unexpected{ Error{ constants::ERROR_STR_OPERATION_CANCELED, Error::Category::OperationCanceled } };
+      }
+
+      auto isAuthenticationError(const Error& error) -> bool
+      {
+         return error.error_code == std::to_underlying(HttpStatus::Code::Unauthorized);
+      }
+   }
+
+
+   [[nodiscard]] auto downloadTables(const CredentialWrapper& cred, std::span<const TableId> tables, DataFormatId format, 
+                                     const fs::path& data_folder, std::stop_token stop_token, ProgressCallback* callback, 
+                                     const TableDownloadFunc& download_table, size_t max_concurrent) -> TableSyncResults
+   {
+      // every result starts out as canceled, and gets replaced when its download runs
+      TableSyncResults results{ std::from_range, tables | vws::transform([](TableId tbl) { return TableSyncResult{ tbl, canceledResult() }; }) };
+      if (tables.empty())
+         return results;
+
+      // our own stop source lets us cancel from the callback or on auth failure, as well as from the caller's token.
+      std::stop_source stop_source{};
+      std::stop_callback forward_stop{ stop_token, [&stop_source] { stop_source.request_stop(); } };
+
+      std::vector<DownloadProgress> progress(tables.size());
+      std::atomic<size_t>           next_table{};
+      std::mutex                    mutex{};
+      std::condition_variable       done_cv{};
+      auto worker_count = std::clamp(max_concurrent, size_t{ 1 }, tables.size());
+      auto active_workers = worker_count;
+
+      auto worker = [&]
+         {
+            auto stop = stop_source.get_token();
+            for (auto idx = next_table++; idx < tables.size() and not stop.stop_requested(); idx = next_table++)
+            {
+               ProgressCallback table_callback = [&progress, idx, stop](int64_t download_total, int64_t download_now, int64_t, int64_t, intptr_t) -> bool
+                  {
+                     progress[idx].download_total = download_total;
+                     progress[idx].download_now   = download_now;
+                     return not stop.stop_requested();
+                  };
+
+               try
+               {
+                  auto table_path = getTablePath(data_folder, tables[idx], format);
+                  auto result = download_table ? download_table(cred, tables[idx], format, table_path, &table_callback)
+                                               : downloadTableFile(cred, tables[idx], format, table_path, nullptr, &table_callback);
+                  if (!result and isAuthenticationError(result.error()))
+                  {
+                     stop_source.request_stop();
+                  }
+                  results[idx].result = std::move(result); // each index is only written by one worker.
+               }
+               catch (...)
+               {
+                  results[idx].result = std::unexpected{ packageError() };
+               }
+            }
+
+            std::lock_guard lock{ mutex };
+            --active_workers;
+            done_cv.notify_one();
+         };
+
+      std::vector<std::jthread> workers{};
+      workers.reserve(worker_count);
+      for (size_t i = 0; i < worker_count; ++i)
+      {
+         workers.emplace_back(worker);
+      }
+
+      // wait for the workers to finish, reporting aggregate progress on this thread while we wait.
+      std::unique_lock lock{ mutex };
+      while (not done_cv.wait_for(lock, std::chrono::milliseconds{ constants::SYNC_PROGRESS_INTERVAL_MS }, [&active_workers] { return active_workers == 0; }))
+      {
+         if (callback)
+         {
+            lock.unlock();
+            int64_t download_total{}, download_now{};
+            for (const auto& table_progress : progress)
+            {
+               download_total += table_progress.download_total;
+               download_now   += table_progress.download_now;
+            }
+            if (not (*callback)(download_total, download_now, 0, 0, 0))
+            {
+               stop_source.request_stop();
+            }
+            lock.lock();
+         }
+      }
+      lock.unlock();
+      workers.clear();  // joins
+
+      return results;
+   }
+
+
+} // namespace ctb
@@ -17,12 +17,20 @@ namespace ctb::tasks
    {
       // there was originally more to these functions when implementing a coroutine for libcoro, but
       // when that approach was abandoned for std::async() there wasn't much left. I decided to keep the 
-      // encapsulation because at some point I'll probably want to move to asio/cobalt or P2300/?? or ??/??...
+      // encapsulation so these can be run synchronously, deferred, or on a TaskExecutor.
       checkStopToken(token);
       return readBinaryFile(file);
    }
 
 
+   auto loadFileAsync(TaskExecutorPtr executor, fs::path file, TaskExecutor::Priority priority, stop_token token) -> CoTask<Buffer>
+   {
+      checkStopToken(token);
+      co_await schedule(*executor, priority);
+      co_return runLoadFileTask(std::move(file), token);
+   }
+
+
    auto runLabelDownloadTask(uint64_t wine_id, std::stop_token token) noexcept(false)-> FetchFileTask::ReturnType
    {
       checkStopToken(token);
@@ -1,4 +1,9 @@
 #include "ctb/utility.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
 #include <fstream>
 #include <limits>
 
@@ -24,9 +29,204 @@ namespace ctb
 
       }
 
+      /// @brief Unicode code points for Windows-1252 bytes 0x80-0x9F, the only range where it differs from Latin-1. 
+      ///
+      /// The five undefined bytes map to the corresponding C1 control code, which is what Windows does and 
+      /// means every byte round-trips.
+      constexpr std::array<char16_t, 32> Cp1252HighChars{
+         u'\u20AC', u'\u0081', u'\u201A', u'\u0192', u'\u201E', u'\u2026', u'\u2020', u'\u2021',
+         u'\u02C6', u'\u2030', u'\u0160', u'\u2039', u'\u0152', u'\u008D', u'\u017D', u'\u008F',
+         u'\u0090', u'\u2018', u'\u2019', u'\u201C', u'\u201D', u'\u2022', u'\u2013', u'\u2014',
+         u'\u02DC', u'\u2122', u'\u0161', u'\u203A', u'\u0153', u'\u009D', u'\u017E', u'\u0178'
+      };
+
+      constexpr unsigned char FirstHighByte = 0x80;
+      constexpr unsigned char FirstLatin1Byte = 0xA0;
+
+      /// @brief pre-encoded UTF-8 sequence for a single non-ASCII code page byte.
+      struct Utf8Seq
+      {
+         std::array<char, 3> bytes{};
+         uint8_t             length{};
+      };
+
+      /// @brief table of UTF-8 sequences for code page bytes 0x80-0xFF, indexed by (byte - 0x80)
+      using Utf8Table = std::array<Utf8Seq, 128>;
+
+      constexpr auto encodeUTF8(char32_t code_point) -> Utf8Seq
+      {
+         if (code_point < 0x800)
+         {
+            return { { static_cast<char>(0xC0 | (code_point >> 6)), 
+                       static_cast<char>(0x80 | (code_point & 0x3F)) }, 2 };
+         }
+         return { { static_cast<char>(0xE0 | (code_point >> 12)),
+                    static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)),
+                    static_cast<char>(0x80 | (code_point & 0x3F)) }, 3 };
+      }
+
+      constexpr auto makeUtf8Table(bool windows_1252) -> Utf8Table
+      {
+         Utf8Table table{};
+         for (size_t i = 0; i < table.size(); ++i)
+         {
+            auto code_point = static_cast<char32_t>(FirstHighByte + i);
+            if (windows_1252 and code_point < FirstLatin1Byte)
+               code_point = Cp1252HighChars[code_point - FirstHighByte];
+
+            table[i] = encodeUTF8(code_point);
+         }
+         return table;
+      }
+
+      constexpr Utf8Table Cp1252ToUtf8Table  = makeUtf8Table(true);
+      constexpr Utf8Table Latin1ToUtf8Table  = makeUtf8Table(false);
+
+      auto getUtf8Table(unsigned int code_page) -> const Utf8Table*
+      {
+         switch (code_page)
+         {
+            case CP_WINDOWS_1252:   return &Cp1252ToUtf8Table;
+            case CP_ISO_LATIN_1:    return &Latin1ToUtf8Table;
+            default:                return nullptr;
+         }
+      }
+
+      /// @brief returns the length of the leading run of 7-bit ASCII chars in text.
+      ///
+      /// Most of our data is plain ASCII, so this checks 8 bytes at a time for any high bits
+      /// and lets the callers copy those runs as a block.
+      auto asciiPrefixLength(std::string_view text) noexcept -> size_t
+      {
+         constexpr uint64_t high_bits = 0x8080808080808080ull;
+
+         size_t pos{};
+         for (; pos + sizeof(uint64_t) <= text.size(); pos += sizeof(uint64_t))
+         {
+            uint64_t block{};
+            std::memcpy(&block, text.data() + pos, sizeof(block));
+            if (auto high = block & high_bits; high)
+            {
+               // first high bit tells us which byte is non-ASCII
+               if constexpr (std::endian::native == std::endian::little)
+                  return pos + static_cast<size_t>(std::countr_zero(high) / 8);
+               else
+                  return pos + static_cast<size_t>(std::countl_zero(high) / 8);
+            }
+         }
+         while (pos < text.size() and static_cast<unsigned char>(text[pos]) < FirstHighByte)
+            ++pos;
+
+         return pos;
+      }
+
+      /// @brief decode the next UTF-8 sequence from text starting at pos, advancing pos past it
+      /// @return the code point, or std::nullopt if the sequence is invalid.
+      auto decodeUTF8(std::string_view text, size_t& pos) noexcept -> std::optional<char32_t>
+      {
+         auto lead = static_cast<unsigned char>(text[pos]);
+
+         size_t length{};
+         char32_t code_point{};
+         char32_t min_value{};
+         if ((lead & 0xE0) == 0xC0)
+         {
+            length = 2; code_point = lead & 0x1F; min_value = 0x80;
+         }
+         else if ((lead & 0xF0) == 0xE0)
+         {
+            length = 3; code_point = lead & 0x0F; min_value = 0x800;
+         }
+         else if ((lead & 0xF8) == 0xF0)
+         {
+            length = 4; code_point = lead & 0x07; min_value = 0x10000;
+         }
+         else {
+            return std::nullopt;
+         }
+
+         if (pos + length > text.size())
+            return std::nullopt;
+
+         for (size_t i = 1; i < length; ++i)
+         {
+            auto next = static_cast<unsigned char>(text[pos + i]);
+            if ((next & 0xC0) != 0x80)
+               return std::nullopt;
+
+            code_point = (code_point << 6) | (next & 0x3F);
+         }
+
+         // reject overlong encodings, surrogates and out-of-range values
+         if (code_point < min_value or code_point > 0x10FFFF or (code_point >= 0xD800 and code_point <= 0xDFFF))
+            return std::nullopt;
+
+         pos += length;
+         return code_point;
+      }
+
+      /// @brief map a non-ASCII code point to a code page byte, or '?' if it can't be represented
+      auto encodeCodePage(char32_t code_point, bool windows_1252) noexcept -> char
+      {
+         constexpr char replacement = '?';
+
+         // nothing outside the BMP maps to a code page byte, and it would be truncated by the char16_t lookup below.
+         if (code_point > 0xFFFF)
+            return replacement;
+
+         if (code_point > 0xFF)
+         {
+            if (!windows_1252)
+               return replacement;
+
+            auto it = rng::find(Cp1252HighChars, static_cast<char16_t>(code_point));
+            return it == Cp1252HighChars.end() ? replacement 
+                                               : static_cast<char>(FirstHighByte + std::distance(Cp1252HighChars.begin(), it));
+         }
+
+         // 0x80-0x9F are C1 controls in Latin-1, but in 1252 only the undefined bytes map back to themselves.
+         if (windows_1252 and code_point < FirstLatin1Byte and Cp1252HighChars[code_point - FirstHighByte] != code_point)
+            return replacement;
+
+         return static_cast<char>(code_point);
+      }
+
    } // namespace
 
 
+   [[nodiscard]] auto appendUTF8(std::string_view text, std::string& dest, unsigned int code_page) -> bool
+   {
+      const auto* table = getUtf8Table(code_page);
+      if (!table)
+      {
+         auto converted = toUTF8(text, code_page);
+         if (!converted)
+            return false;
+
+         dest.append(*converted);
+         return true;
+      }
+
+      // non-ASCII chars take 2-3 bytes, we reserve a little extra so we don't need to reallocate for mostly-ASCII text. 
+      dest.reserve(dest.size() + text.size() + text.size() / 8);
+
+      while (!text.empty())
+      {
+         auto ascii_len = asciiPrefixLength(text);
+         dest.append(text.substr(0, ascii_len));
+         text.remove_prefix(ascii_len);
+
+         while (!text.empty() and static_cast<unsigned char>(text.front()) >= FirstHighByte)
+         {
+            const auto& seq = (*table)[static_cast<unsigned char>(text.front()) - FirstHighByte];
+            dest.append(seq.bytes.data(), seq.length);
+            text.remove_prefix(1);
+         }
+      }
+      return true;
+   }
+
+
    auto readBinaryFile(const fs::path& file_path, uint32_t max_size) noexcept(false) -> Buffer
    {
       constexpr auto max_stream = std::numeric_limits<std::streamsize>::max();
@@ -134,63 +334,123 @@ namespace ctb
    }
 
 
-   [[nodiscard]] auto toUTF8(const std::string& text, unsigned int code_page) -> MaybeString
+   namespace
    {
-      int length = MultiByteToWideChar(code_page, MB_PRECOMPOSED|MB_ERR_INVALID_CHARS, text.c_str(), -1, nullptr, 0);
-      if (!length)
-         return {};
+      auto win32ToUTF8(std::string_view text, unsigned int code_page) -> MaybeString
+      {
+         if (text.empty())
+            return std::string{};
+
+         auto text_len = static_cast<int>(text.size());
+         int length = MultiByteToWideChar(code_page, MB_PRECOMPOSED|MB_ERR_INVALID_CHARS, text.data(), text_len, nullptr, 0);
+         if (!length)
+            return {};
+
+         std::wstring wide_buf(static_cast<size_t>(length), L'\0');
+         if (!MultiByteToWideChar(code_page, MB_PRECOMPOSED|MB_ERR_INVALID_CHARS, text.data(), text_len, wide_buf.data(), length))
+            return {};
+
+         // Get needed buffer length since some UTF-16 chars may need multiple bytes in UTF-8. 
+         auto wide_len = static_cast<int>(wide_buf.size());
+         length = WideCharToMultiByte(CP_UTF8, WC_COMPOSITECHECK|WC_ERR_INVALID_CHARS|WC_NO_BEST_FIT_CHARS, wide_buf.data(), wide_len, nullptr, 0, nullptr, nullptr);
+         if (!length)
+            return {};
+
+         // Now allocate buffer and make the final call to do the conversion.
+         std::string utf8_buf(static_cast<size_t>(length), '\0');
+         if (WideCharToMultiByte(CP_UTF8, WC_COMPOSITECHECK|WC_ERR_INVALID_CHARS|WC_NO_BEST_FIT_CHARS, wide_buf.data(), wide_len, utf8_buf.data(), length, nullptr, nullptr))
+            return utf8_buf;
 
-      std::vector<wchar_t> wide_buf(static_cast<size_t>(length), '\0');
-      if (!MultiByteToWideChar(code_page, MB_PRECOMPOSED|MB_ERR_INVALID_CHARS,  text.c_str(), -1, wide_buf.data(), static_cast<int>(wide_buf.size())))
          return {};
+      }
+
+      auto win32FromUTF8(std::string_view utf_text, unsigned int to_code_page) -> MaybeString
+      {
+         if (utf_text.empty())
+            return std::string{};
+
+         // First convert UTF-8 to UTF-16
+         auto text_len = static_cast<int>(utf_text.size());
+         int length = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, utf_text.data(), text_len, nullptr, 0);
+         if (!length)
+            return {};
+
+         std::wstring wide_buf(static_cast<size_t>(length), L'\0');
+         if (!MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, utf_text.data(), text_len, wide_buf.data(), length))
+            return {};
+
+         // Get needed buffer length for the target code page then do the conversion
+         auto wide_len = static_cast<int>(wide_buf.size());
+         length = WideCharToMultiByte(to_code_page, WC_COMPOSITECHECK|WC_NO_BEST_FIT_CHARS, wide_buf.data(), wide_len, nullptr, 0, nullptr, nullptr);
+         if (!length)
+            return {};
+
+         std::string mb_buf(static_cast<size_t>(length), '\0');
+         if (WideCharToMultiByte(to_code_page, WC_COMPOSITECHECK|WC_NO_BEST_FIT_CHARS, wide_buf.data(), wide_len, mb_buf.data(), length, nullptr, nullptr))
+            return mb_buf;
 
-      // Get needed buffer length since some UTF-16 chars may need multiple bytes in UTF-8. 
-      length = WideCharToMultiByte(CP_UTF8, WC_COMPOSITECHECK|WC_ERR_INVALID_CHARS|WC_NO_BEST_FIT_CHARS, wide_buf.data(), -1, nullptr, 0, nullptr, nullptr);
-      if (!length)
          return {};
+      }
+
+   } // namespace
+
+#endif
+
+
+   [[nodiscard]] auto toUTF8(std::string_view text, unsigned int code_page) -> MaybeString
+   {
+      if (getUtf8Table(code_page))
+      {
+         std::string result{};
+         if (appendUTF8(text, result, code_page))
+            return result;
 
-      // Now allocate buffer and make the final call to do the conversion.
-      std::vector<char> utf8_buf(static_cast<size_t>(length), '\0');
-      if (WideCharToMultiByte(CP_UTF8, WC_COMPOSITECHECK|WC_ERR_INVALID_CHARS|WC_NO_BEST_FIT_CHARS, wide_buf.data(), -1, utf8_buf.data(), static_cast<int>(utf8_buf.size()), nullptr, nullptr))
-         return std::string{ utf8_buf.data() };
+         return {};
+      }
 
+   #if defined(_WIN32_WINNT)
+      return win32ToUTF8(text, code_page);
+   #else
       return {};
+   #endif
    }
 
-   [[nodiscard]] auto fromUTF8(const std::string& utf_text, unsigned int to_code_page) -> MaybeString
+
+   [[nodiscard]] auto fromUTF8(std::string_view utf_text, unsigned int to_code_page) -> MaybeString
    {
-      MaybeString result{};
+      if (!getUtf8Table(to_code_page))
+      {
+      #if defined(_WIN32_WINNT)
+         return win32FromUTF8(utf_text, to_code_page);
+      #else
+         return {};
+      #endif
+      }
 
-      // First convert UTF-8 to UTF-16
-      int length = MultiByteToWideChar(CP_UTF8, MB_PRECOMPOSED|MB_ERR_INVALID_CHARS, utf_text.c_str(), -1, nullptr, 0);
-      if (!length)
-         return result;
+      const bool windows_1252 = to_code_page == CP_WINDOWS_1252;
 
-      std::vector<wchar_t> wide_buf(static_cast<size_t>(length), '\0');
-      if (!MultiByteToWideChar(CP_UTF8, MB_PRECOMPOSED|MB_ERR_INVALID_CHARS, utf_text.c_str(), -1, wide_buf.data(), static_cast<int>(wide_buf.size())))
-         return result;
+      // output is never longer than the input, since every non-ASCII char is at least 2 bytes in UTF-8
+      std::string result{};
+      result.reserve(utf_text.size());
 
-      // Get needed buffer length for the target code page then do the conversion
-      length = WideCharToMultiByte(to_code_page, WC_COMPOSITECHECK|WC_NO_BEST_FIT_CHARS, wide_buf.data(), -1, nullptr, 0, nullptr, nullptr);
-      if (length)
+      size_t pos{};
+      while (pos < utf_text.size())
       {
-         std::vector<char> mb_buf(static_cast<size_t>(length), '\0');
-         length = WideCharToMultiByte(to_code_page, WC_COMPOSITECHECK|WC_NO_BEST_FIT_CHARS, wide_buf.data(), -1, mb_buf.data(), static_cast<int>(mb_buf.size()), nullptr, nullptr);
-         if (length)
+         auto ascii_len = asciiPrefixLength(utf_text.substr(pos));
+         result.append(utf_text.substr(pos, ascii_len));
+         pos += ascii_len;
+
+         if (pos < utf_text.size())
          {
-            // Since utf8_text.data() and utf8_text.size() to pass the string to MultiByteToWideChar, it gets treated as non-null-terminated and we have to terminate result string.
-            std::string retval{ mb_buf.data() };
-            retval.push_back('\0'); 
-            result = retval;
+            auto code_point = decodeUTF8(utf_text, pos);
+            if (!code_point)
+               return {};
+
+            result.push_back(encodeCodePage(*code_point, windows_1252));
          }
       }
- 
       return result;
    }
 
-#else
-   // TODO: provide implementation for other platforms when needed.
-#endif
-
 
 } // namespace ctb
\ No newline at end of file
@@ -0,0 +1,266 @@
+/*******************************************************************
+ * @file LocalHttpServer.h
+ *
+ * @brief Header file for the LocalHttpServer test helper
+ *
+ * @copyright Copyright © 2025 Jeff Kohn. All rights reserved.
+ *******************************************************************/
+#pragma once
+
+#if defined(_WIN32)
+   #ifndef NOMINMAX
+      #define NOMINMAX
+   #endif
+   #ifndef WIN32_LEAN_AND_MEAN
+      #define WIN32_LEAN_AND_MEAN
+   #endif
+   #include <winsock2.h>
+   #include <ws2tcpip.h>
+#else
+   #include <arpa/inet.h>
+   #include <netinet/in.h>
+   #include <sys/select.h>
+   #include <sys/socket.h>
+   #include <unistd.h>
+#endif
+
+#include "ctb/ctb_format.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace ctb::test
+{
+   /// @brief a minimal HTTP/1.1 server on the loopback interface, used as a stand-in for CT in download tests.
+   ///
+   /// Requests are handled one at a time on a background thread, and every connection is closed after its
+   /// response. The handler is called on that thread with the parsed request, and returns the full response
+   /// text (see makeResponse()). Requests are also recorded, so tests can check what the client sent.
+   ///
+   class LocalHttpServer final
+   {
+   public:
+      struct Request
+      {
+         std::string method{};
+         std::string target{};
+         std::map<std::string, std::string> headers{};   // names are lower-case
+
+         auto header(const std::string& name) const -> std::string
+         {
+            auto it = headers.find(name);
+            return it == headers.end() ? std::string{} : it->second;
+         }
+      };
+
+      using Handler = std::function<std::string(const Request&)>;
+
+      /// @brief start listening on an ephemeral port
+      /// @throws std::runtime_error if the listening socket can't be set up
+      explicit LocalHttpServer(Handler handler) : m_handler{ std::move(handler) }
+      {
+      #if defined(_WIN32)
+         WSADATA wsa_data{};
+         if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0)
+            throw std::runtime_error{ "WSAStartup failed" };
+      #endif
+
+         m_listener = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+         if (m_listener == InvalidSocket)
+            throw std::runtime_error{ "socket() failed" };
+
+         sockaddr_in addr{};
+         addr.sin_family = AF_INET;
+         addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+         addr.sin_port = 0;
+         socklen_t addr_len = sizeof(addr);
+         if (::bind(m_listener, reinterpret_cast<sockaddr*>(&addr), addr_len) != 0 or
+             ::listen(m_listener, SOMAXCONN) != 0 or
+             ::getsockname(m_listener, reinterpret_cast<sockaddr*>(&addr), &addr_len) != 0)
+         {
+            closeSocket(m_listener);
+            throw std::runtime_error{ "failed to listen on loopback interface" };
+         }
+         m_port = ntohs(addr.sin_port);
+         m_worker = std::jthread{ [this](std::stop_token token) { run(token); } };
+      }
+
+      /// @brief the URL of the server, with the specified path
+      auto url(std::string_view path = "/") const -> std::string
+      {
+         return ctb::format("http://127.0.0.1:{}{}", m_port, path);
+      }
+
+      /// @brief returns the requests received so far
+      auto requests() const -> std::vector<Request>
+      {
+         std::lock_guard lock{ m_mutex };
+         return m_requests;
+      }
+
+      /// @brief returns the last request received, or an empty request if there haven't been any
+      auto lastRequest() const -> Request
+      {
+         std::lock_guard lock{ m_mutex };
+         return m_requests.empty() ? Request{} : m_requests.back();
+      }
+
+      /// @brief format a response with the specified status, headers and body
+      static auto makeResponse(int status, std::string_view reason, std::string_view body = {},
+                               std::initializer_list<std::pair<std::string_view, std::string_view>> headers = {}) -> std::string
+      {
+         auto response = ctb::format("HTTP/1.1 {} {}\r\nContent-Length: {}\r\nConnection: close\r\n", status, reason, body.size());
+         for (const auto& [name, value] : headers)
+         {
+            response += ctb::format("{}: {}\r\n", name, value);
+         }
+         response += "\r\n";
+         response += body;
+         return response;
+      }
+
+      ~LocalHttpServer() noexcept
+      {
+         m_worker.request_stop();
+         if (m_worker.joinable())
+            m_worker.join();
+
+         closeSocket(m_listener);
+      #if defined(_WIN32)
+         WSACleanup();
+      #endif
+      }
+
+      LocalHttpServer(const LocalHttpServer&) = delete;
+      LocalHttpServer(LocalHttpServer&&) = delete;
+      LocalHttpServer& operator=(const LocalHttpServer&) = delete;
+      LocalHttpServer& operator=(LocalHttpServer&&) = delete;
+
+   private:
+   #if defined(_WIN32)
+      using SocketHandle = SOCKET;
+      static constexpr SocketHandle InvalidSocket = INVALID_SOCKET;
+      static constexpr int          SendFlags = 0;
+   #else
+      using SocketHandle = int;
+      static constexpr SocketHandle InvalidSocket = -1;
+      static constexpr int          SendFlags = MSG_NOSIGNAL;  // client hanging up shouldn't kill the test run
+   #endif
+      static constexpr int PollIntervalMs = 50;
+
+      Handler              m_handler{};
+      SocketHandle         m_listener{ InvalidSocket };
+      uint16_t             m_port{};
+      mutable std::mutex   m_mutex{};
+      std::vector<Request> m_requests{};
+      std::jthread         m_worker{};   // must be declared last, so it's stopped before anything it uses is destroyed.
+
+      static void closeSocket(SocketHandle socket)
+      {
+      #if defined(_WIN32)
+         ::closesocket(socket);
+      #else
+         ::close(socket);
+      #endif
+      }
+
+      /// @brief wait for a connection, with a timeout so we can check for stop requests
+      auto waitForConnection() -> bool
+      {
+         fd_set read_set{};
+         FD_ZERO(&read_set);
+         FD_SET(m_listener, &read_set);
+         timeval timeout{ 0, PollIntervalMs * 1000 };
+         return ::select(static_cast<int>(m_listener) + 1, &read_set, nullptr, nullptr, &timeout) > 0;
+      }
+
+      void run(std::stop_token token)
+      {
+         while (not token.stop_requested())
+         {
+            if (not waitForConnection())
+               continue;
+
+            auto connection = ::accept(m_listener, nullptr, nullptr);
+            if (connection == InvalidSocket)
+               continue;
+
+            auto request = readRequest(connection);
+            auto response = m_handler(request);
+            {
+               std::lock_guard lock{ m_mutex };
+               m_requests.push_back(std::move(request));
+            }
+            for (size_t sent = 0; sent < response.size(); )
+            {
+               auto count = ::send(connection, response.data() + sent, static_cast<int>(response.size() - sent), SendFlags);
+               if (count <= 0)
+                  break;
+
+               sent += static_cast<size_t>(count);
+            }
+            closeSocket(connection);
+         }
+      }
+
+      /// @brief read a request's line and headers. We only handle GET, so there's no body to read.
+      static auto readRequest(SocketHandle connection) -> Request
+      {
+         std::string text{};
+         char buffer[1024]{};
+         while (text.find("\r\n\r\n") == std::string::npos)
+         {
+            auto count = ::recv(connection, buffer, static_cast<int>(sizeof(buffer)), 0);
+            if (count <= 0)
+               break;
+
+            text.append(buffer, static_cast<size_t>(count));
+         }
+
+         Request request{};
+         std::string_view remaining{ text };
+         auto nextLine = [&remaining]
+            {
+               auto pos = remaining.find("\r\n");
+               auto line = remaining.substr(0, pos);
+               remaining.remove_prefix(pos == std::string_view::npos ? remaining.size() : pos + 2);
+               return line;
+            };
+
+         auto request_line = nextLine();
+         auto method_end = request_line.find(' ');
+         auto target_end = request_line.find(' ', method_end + 1);
+         request.method = request_line.substr(0, method_end);
+         request.target = request_line.substr(method_end + 1, target_end - method_end - 1);
+
+         for (auto line = nextLine(); not line.empty(); line = nextLine())
+         {
+            auto colon = line.find(':');
+            if (colon == std::string_view::npos)
+               continue;
+
+            std::string name{ line.substr(0, colon) };
+            std::ranges::transform(name, name.begin(), [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+
+            auto value = line.substr(colon + 1);
+            while (not value.empty() and value.front() == ' ')
+               value.remove_prefix(1);
+
+            request.headers[name] = value;
+         }
+         return request;
+      }
+   };
+
+} // namespace ctb::test
@@ -0,0 +1,51 @@
+/*******************************************************************
+ * @file TempFolder.h
+ *
+ * @brief Header file for the TempFolder test helper
+ *
+ * @copyright Copyright © 2025 Jeff Kohn. All rights reserved.
+ *******************************************************************/
+#pragma once
+
+#include "ctb/ctb_format.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+
+namespace ctb::test
+{
+   namespace fs = std::filesystem;
+
+
+   /// @brief a temporary folder that's removed when the test is done
+   struct TempFolder
+   {
+      fs::path path{ fs::temp_directory_path() / ctb::format("ctb_test_{}", std::chrono::steady_clock::now().time_since_epoch().count()) };
+
+      TempFolder()  { fs::create_directories(path); }
+      ~TempFolder() { std::error_code ec{}; fs::remove_all(path, ec); }
+   };
+
+
+   inline auto readFile(const fs::path& path) -> std::string
+   {
+      std::ifstream file{ path, std::ios::binary };
+      std::ostringstream text{};
+      text << file.rdbuf();
+      return text.str();
+   }
+
+
+   inline void writeFile(const fs::path& path, std::string_view text)
+   {
+      std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+      file << text;
+   }
+
+} // namespace ctb::test
@@ -0,0 +1,126 @@
+/*********************************************************************
+ * @file       table_download_test.cpp
+ *
+ * @brief      tests for conditional table downloads, using a local stand-in for CT
+ *
+ * @copyright  Copyright © 2025 Jeff Kohn. All rights reserved.
+ *********************************************************************/
+#include "LocalHttpServer.h"
+#include "TempFolder.h"
+
+#include <ctb/table_download.h>
+#include <ctb/utility_http.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+
+
+namespace
+{
+   using namespace ctb;
+   using test::LocalHttpServer;
+   using test::TempFolder;
+   using test::readFile;
+
+   constexpr std::string_view TABLE_V1 = "iWine,Wine\n1,Foo\n";
+   constexpr std::string_view TABLE_V2 = "iWine,Wine\n1,Foo\n2,Bar\n";
+   constexpr std::string_view ETAG_V1  = "\"v1\"";
+   constexpr std::string_view ETAG_V2  = "\"v2\"";
+
+
+   /// @brief a stand-in for CT that serves one version of a table, and honors If-None-Match unless told not to
+   struct TableServer
+   {
+      std::atomic<bool> use_v2{ false };
+      std::atomic<bool> honor_validators{ true };
+
+      LocalHttpServer server{ [this](const LocalHttpServer::Request& request)
+         {
+            auto etag = use_v2 ? ETAG_V2 : ETAG_V1;
+            if (honor_validators and request.header(headers::IF_NONE_MATCH_KEY) == etag)
+               return LocalHttpServer::makeResponse(304, "Not Modified");
+
+            return LocalHttpServer::makeResponse(200, "OK", use_v2 ? TABLE_V2 : TABLE_V1, { { "ETag", etag } });
+         }};
+
+      auto download(const fs::path& file_path) -> TableFileResult
+      {
+         CredentialWrapper cred{ "test", std::string{ "user" }, std::string{ "password" } };
+         return downloadTableFile(cred, TableId::List, DataFormatId::csv, file_path, nullptr, nullptr, false, CP_WINDOWS_1252, server.url("/xlquery.asp"));
+      }
+
+      auto lastValidator() const -> std::string
+      {
+         return server.lastRequest().header(headers::IF_NONE_MATCH_KEY);
+      }
+   };
+}
+
+
+TEST_CASE("downloadTableFile uses validators to skip unchanged tables", "[table_download]")
+{
+   TempFolder folder{};
+   auto table_path = getTablePath(folder.path, TableId::List, DataFormatId::csv);
+   TableServer ct{};
+
+   // first download has nothing to validate against
+   auto result = ct.download(table_path);
+   REQUIRE(result.has_value());
+   CHECK(*result);
+   CHECK(ct.lastValidator().empty());
+   CHECK(readFile(table_path) == TABLE_V1);
+
+   SECTION("304 Not Modified leaves the file alone")
+   {
+      auto last_write = fs::last_write_time(table_path);
+
+      result = ct.download(table_path);
+      REQUIRE(result.has_value());
+      CHECK_FALSE(*result);
+      CHECK(ct.lastValidator() == ETAG_V1);
+      CHECK(readFile(table_path) == TABLE_V1);
+      CHECK(fs::last_write_time(table_path) == last_write);
+
+      auto temp_path{ table_path };
+      CHECK_FALSE(fs::exists(temp_path.replace_extension(constants::DOWNLOAD_FILE_EXTENSION)));
+   }
+
+   SECTION("unchanged content is detected when the server ignores validators")
+   {
+      ct.honor_validators = false;
+
+      result = ct.download(table_path);
+      REQUIRE(result.has_value());
+      CHECK_FALSE(*result);
+      CHECK(readFile(table_path) == TABLE_V1);
+   }
+
+   SECTION("stale validators are replaced when the table changes")
+   {
+      ct.use_v2 = true;
+
+      result = ct.download(table_path);
+      REQUIRE(result.has_value());
+      CHECK(*result);
+      CHECK(ct.lastValidator() == ETAG_V1);
+      CHECK(readFile(table_path) == TABLE_V2);
+
+      // the next request has to use the new validator, the old one would get the table again
+      result = ct.download(table_path);
+      REQUIRE(result.has_value());
+      CHECK_FALSE(*result);
+      CHECK(ct.lastValidator() == ETAG_V2);
+   }
+
+   SECTION("validators are ignored if the table file is missing")
+   {
+      fs::remove(table_path);
+
+      result = ct.download(table_path);
+      REQUIRE(result.has_value());
+      CHECK(*result);
+      CHECK(ct.lastValidator().empty());
+      CHECK(readFile(table_path) == TABLE_V1);
+   }
+}
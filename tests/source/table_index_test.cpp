@@ -0,0 +1,78 @@
+/*********************************************************************
+ * @file       table_index_test.cpp
+ *
+ * @brief      tests for the TableIndex class
+ *
+ * @copyright  Copyright © 2025 Jeff Kohn. All rights reserved.
+ *********************************************************************/
+#include <ctb/tables/detail/TableIndex.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <optional>
+#include <vector>
+
+
+namespace
+{
+   using ctb::detail::TableIndex;
+
+   /// @brief builds an index over a column of wine id's, where 0 means the row has no key
+   auto makeIndex(const std::vector<uint64_t>& wine_ids) -> TableIndex<uint64_t>
+   {
+      return TableIndex<uint64_t>{ wine_ids.size(), [&wine_ids](size_t row) -> std::optional<uint64_t>
+         {
+            return wine_ids[row] ? std::optional{ wine_ids[row] } : std::nullopt;
+         }};
+   }
+
+   auto toVector(TableIndex<uint64_t>::RowSpan rows) -> std::vector<size_t>
+   {
+      return { rows.begin(), rows.end() };
+   }
+}
+
+
+TEST_CASE("TableIndex finds every row for a key in table order", "[table_index]")
+{
+   auto index = makeIndex({ 7, 3, 7, 5, 3, 7 });
+
+   CHECK(toVector(index.find(7)) == std::vector<size_t>{ 0, 2, 5 });
+   CHECK(toVector(index.find(3)) == std::vector<size_t>{ 1, 4 });
+   CHECK(toVector(index.find(5)) == std::vector<size_t>{ 3 });
+
+   CHECK(index.keyCount() == 3);
+   CHECK(index.rowCount() == 6);
+}
+
+
+TEST_CASE("TableIndex returns no rows for a missing key", "[table_index]")
+{
+   auto index = makeIndex({ 1, 2 });
+
+   CHECK(index.find(3).empty());
+   CHECK_FALSE(index.contains(3));
+   CHECK(index.contains(1));
+}
+
+
+TEST_CASE("TableIndex skips rows without a key", "[table_index]")
+{
+   auto index = makeIndex({ 0, 4, 0, 4, 0 });
+
+   CHECK(toVector(index.find(4)) == std::vector<size_t>{ 1, 3 });
+   CHECK(index.keyCount() == 1);
+   CHECK(index.rowCount() == 2);
+}
+
+
+TEST_CASE("TableIndex handles empty tables", "[table_index]")
+{
+   auto index = makeIndex({});
+   CHECK(index.keyCount() == 0);
+   CHECK(index.rowCount() == 0);
+   CHECK(index.find(1).empty());
+
+   TableIndex<uint64_t> default_index{};
+   CHECK(default_index.find(1).empty());
+}
@@ -0,0 +1,111 @@
+/*********************************************************************
+ * @file       table_parse_test.cpp
+ *
+ * @brief      tests for parsing tables with lazy fields, from disk and incrementally
+ *
+ * @copyright  Copyright © 2025 Jeff Kohn. All rights reserved.
+ *********************************************************************/
+#include "TempFolder.h"
+
+#include <ctb/table_data.h>
+#include <ctb/tables/TastingNotesTraits.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <string_view>
+
+
+namespace
+{
+   using namespace ctb;
+   using test::TempFolder;
+   using test::writeFile;
+
+   // note id and wine id are the first two columns
+   constexpr size_t NOTES_COL_COUNT   = 39;
+   constexpr size_t NOTES_COL_WINE_ID = 1;
+   constexpr size_t NOTES_COL_NOTES   = 31;
+
+   // enough rows to span several parse batches
+   constexpr size_t NOTE_COUNT = 6 * constants::STREAM_PARSE_BATCH_BYTES / 256;
+
+
+   /// @brief the tasting note for a row. Every few notes has a comma, an embedded line break or escaped quotes.
+   auto noteText(size_t row) -> std::string
+   {
+      auto text = ctb::format("Note {} with enough text that it can't be stored inline", row);
+      switch (row % 4)
+      {
+         case 1:  text += ", and a comma";                 break;
+         case 2:  text += "\non two lines";                break;
+         case 3:  text += " and \"quoted\" text";          break;
+         default: break;
+      }
+      return text;
+   }
+
+   /// @brief CSV text for a Notes table with NOTE_COUNT rows
+   auto notesCsv() -> std::string
+   {
+      auto empty_cols = [](size_t count) { return std::string(count, ','); };
+
+      std::string text{ "iTastingNote,iWine" };
+      text += empty_cols(NOTES_COL_COUNT - 2) + "\n";
+      for (size_t row = 0; row < NOTE_COUNT; ++row)
+      {
+         std::string note{ noteText(row) };
+         std::string quoted{ "\"" };
+         for (auto ch : note)
+         {
+            quoted += ch;
+            if (ch == '"')
+               quoted += ch;
+         }
+         quoted += "\"";
+
+         text += ctb::format("{},{}", row + 1, row % 10 + 1);
+         text += empty_cols(NOTES_COL_NOTES - NOTES_COL_WINE_ID) + quoted;
+         text += empty_cols(NOTES_COL_COUNT - NOTES_COL_NOTES - 1) + "\n";
+      }
+      return text;
+   }
+
+   void checkNotes(const TastingNotesTable& table)
+   {
+      REQUIRE(table.size() == NOTE_COUNT);
+      for (size_t row = 0; row < NOTE_COUNT; ++row)
+      {
+         INFO("row " << row);
+         CHECK(table[row].getProperty(CtProp::iTastingNoteId).asUInt64() == row + 1);
+         CHECK(table[row].getProperty(CtProp::TastingNotes).asStringView() == noteText(row));
+      }
+   }
+}
+
+
+TEST_CASE("loadTableData keeps lazy fields intact", "[table_data]")
+{
+   TempFolder folder{};
+   writeFile(getTablePath(folder.path, TableId::Notes), notesCsv());
+
+   auto table = loadTableData<TastingNotesTable>(folder.path, TableId::Notes);
+   REQUIRE(table.has_value());
+   checkNotes(*table);
+}
+
+
+TEST_CASE("IncrementalTableParser keeps lazy fields intact across batches", "[table_data]")
+{
+   auto text = notesCsv();
+   REQUIRE(text.size() > 2 * constants::STREAM_PARSE_BATCH_BYTES);
+
+   // odd-sized chunks, so rows and quoted fields get split between them
+   constexpr size_t chunk_size = 1021;
+   IncrementalTableParser<TastingNotesTable> parser{};
+   for (size_t pos = 0; pos < text.size(); pos += chunk_size)
+   {
+      parser.feed(std::string_view{ text }.substr(pos, chunk_size));
+   }
+   checkNotes(parser.finish());
+}
@@ -0,0 +1,89 @@
+/*********************************************************************
+ * @file       utility_test.cpp
+ *
+ * @brief      tests for code page conversion in utility.h
+ *
+ * @copyright  Copyright © 2025 Jeff Kohn. All rights reserved.
+ *********************************************************************/
+#include <ctb/utility.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+
+
+namespace
+{
+   using namespace ctb;
+
+   /// @brief every byte value from 0x01 to 0xFF, so we can check that a whole code page round-trips
+   auto allBytes() -> std::string
+   {
+      std::string bytes{};
+      for (int i = 1; i <= 0xFF; ++i)
+      {
+         bytes.push_back(static_cast<char>(i));
+      }
+      return bytes;
+   }
+}
+
+
+TEST_CASE("Windows-1252 round-trips through UTF-8", "[utility][code_page]")
+{
+   auto bytes = allBytes();
+
+   auto utf8 = toUTF8(bytes, CP_WINDOWS_1252);
+   REQUIRE(utf8.has_value());
+   CHECK(fromUTF8(*utf8, CP_WINDOWS_1252) == bytes);
+}
+
+
+TEST_CASE("Latin-1 round-trips through UTF-8", "[utility][code_page]")
+{
+   auto bytes = allBytes();
+
+   auto utf8 = toUTF8(bytes, CP_ISO_LATIN_1);
+   REQUIRE(utf8.has_value());
+   CHECK(fromUTF8(*utf8, CP_ISO_LATIN_1) == bytes);
+}
+
+
+TEST_CASE("Windows-1252 high chars convert to the right code points", "[utility][code_page]")
+{
+   CHECK(toUTF8("\x80", CP_WINDOWS_1252) == "€");                     // euro sign
+   CHECK(toUTF8("\x93quoted\x94", CP_WINDOWS_1252) == "“quoted”");
+   CHECK(toUTF8("caf\xE9", CP_WINDOWS_1252) == "café");
+
+   CHECK(fromUTF8("€", CP_WINDOWS_1252) == "\x80");
+   CHECK(fromUTF8("“quoted”", CP_WINDOWS_1252) == "\x93quoted\x94");
+
+   // Latin-1 has no curly quotes
+   CHECK(fromUTF8("“", CP_ISO_LATIN_1) == "?");
+}
+
+
+TEST_CASE("fromUTF8 replaces chars the code page can't represent", "[utility][code_page]")
+{
+   CHECK(fromUTF8("中", CP_WINDOWS_1252) == "?");
+
+   // C1 controls only exist in 1252 for its undefined bytes
+   CHECK(fromUTF8("\u0080", CP_WINDOWS_1252) == "?");
+   CHECK(fromUTF8("\u0081", CP_WINDOWS_1252) == "\x81");
+
+   SECTION("astral plane")
+   {
+      // U+1201C would match U+201C (left double quote) if it were truncated to 16 bits
+      CHECK(fromUTF8("\U0001201C", CP_WINDOWS_1252) == "?");
+      CHECK(fromUTF8("wine \U0001F377 glass", CP_WINDOWS_1252) == "wine ? glass");
+      CHECK(fromUTF8("\U0001F377", CP_ISO_LATIN_1) == "?");
+   }
+}
+
+
+TEST_CASE("fromUTF8 rejects invalid UTF-8", "[utility][code_page]")
+{
+   CHECK_FALSE(fromUTF8("\xC3", CP_WINDOWS_1252).has_value());           // truncated sequence
+   CHECK_FALSE(fromUTF8("\xC0\xAF", CP_WINDOWS_1252).has_value());       // overlong encoding
+   CHECK_FALSE(fromUTF8("\xED\xA0\x80", CP_WINDOWS_1252).has_value());   // surrogate
+}
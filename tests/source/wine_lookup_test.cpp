@@ -0,0 +1,241 @@
+/*********************************************************************
+ * @file       wine_lookup_test.cpp
+ *
+ * @brief      tests for JoinedDataset and WineLookupService, using table files in a temp folder
+ *
+ * @copyright  Copyright © 2025 Jeff Kohn. All rights reserved.
+ *********************************************************************/
+#include "TempFolder.h"
+
+#include <ctb/model/CtDatasetLoader.h>
+#include <ctb/model/JoinedDataset.h>
+#include <ctb/model/WineLookupService.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <initializer_list>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace
+{
+   using namespace ctb;
+   using test::TempFolder;
+   using test::writeFile;
+
+   // number of columns in CT's CSV exports, and the columns the tests use
+   constexpr size_t LIST_COL_COUNT     = 65;
+   constexpr size_t LIST_COL_WINE_ID   = 0;
+   constexpr size_t LIST_COL_QTY       = 2;
+   constexpr size_t LIST_COL_WINE_NAME = 13;
+
+   constexpr size_t NOTES_COL_COUNT    = 39;
+   constexpr size_t NOTES_COL_NOTE_ID  = 0;
+   constexpr size_t NOTES_COL_WINE_ID  = 1;
+   constexpr size_t NOTES_COL_NAME     = 5;
+   constexpr size_t NOTES_COL_NOTES    = 31;
+
+   using CsvValues = std::initializer_list<std::pair<size_t, std::string_view>>;
+
+   /// @brief a CSV line with the specified values in their columns, and the rest empty
+   auto csvLine(size_t col_count, CsvValues values) -> std::string
+   {
+      std::vector<std::string> fields(col_count);
+      for (const auto& [col, value] : values)
+      {
+         fields.at(col) = value;
+      }
+
+      std::string line{};
+      for (size_t col = 0; col < col_count; ++col)
+      {
+         if (col)
+            line += ',';
+
+         line += fields[col];
+      }
+      return line + "\n";
+   }
+
+   auto csvHeader(size_t col_count) -> std::string
+   {
+      std::string line{};
+      for (size_t col = 0; col < col_count; ++col)
+      {
+         if (col)
+            line += ',';
+
+         line += ctb::format("Col{}", col);
+      }
+      return line + "\n";
+   }
+
+   /// @brief write a List table with the specified (wine id, quantity) rows
+   void writeListTable(const fs::path& folder, std::initializer_list<std::pair<std::string_view, std::string_view>> wines)
+   {
+      auto text = csvHeader(LIST_COL_COUNT);
+      for (const auto& [wine_id, qty] : wines)
+      {
+         text += csvLine(LIST_COL_COUNT, { { LIST_COL_WINE_ID, wine_id }, { LIST_COL_QTY, qty }, { LIST_COL_WINE_NAME, "Some Wine" } });
+      }
+      writeFile(getTablePath(folder, TableId::List), text);
+   }
+
+   /// @brief write a Notes table with two notes for wine 1, one for wine 2, and one for wine 3 (which isn't in the List table)
+   void writeNotesTable(const fs::path& folder)
+   {
+      auto text = csvHeader(NOTES_COL_COUNT);
+      text += csvLine(NOTES_COL_COUNT, { { NOTES_COL_NOTE_ID, "101" }, { NOTES_COL_WINE_ID, "1" }, { NOTES_COL_NAME, "Some Wine" }, { NOTES_COL_NOTES, "\"Dark fruit, with a long finish\"" } });
+      text += csvLine(NOTES_COL_COUNT, { { NOTES_COL_NOTE_ID, "102" }, { NOTES_COL_WINE_ID, "1" }, { NOTES_COL_NAME, "Some Wine" }, { NOTES_COL_NOTES, "Still too young" } });
+      text += csvLine(NOTES_COL_COUNT, { { NOTES_COL_NOTE_ID, "103" }, { NOTES_COL_WINE_ID, "2" }, { NOTES_COL_NAME, "Other Wine" } });
+      text += csvLine(NOTES_COL_COUNT, { { NOTES_COL_NOTE_ID, "104" }, { NOTES_COL_WINE_ID, "3" }, { NOTES_COL_NAME, "Gone Wine" } });
+      writeFile(getTablePath(folder, TableId::Notes), text);
+   }
+
+   /// @brief the quantity of each wine in a dataset, keyed by its iWineId
+   auto quantitiesByWine(const IDataset& dataset) -> std::map<uint64_t, NullableShort>
+   {
+      std::map<uint64_t, NullableShort> quantities{};
+      for (int row = 0; row < dataset.rowCount(); ++row)
+      {
+         auto wine_id = dataset.getProperty(row, CtProp::iWineId).asUInt64().value_or(0);
+         quantities[wine_id] = dataset.getProperty(row, CtProp::QtyOnHand).asUInt16();
+      }
+      return quantities;
+   }
+}
+
+
+TEST_CASE("JoinedDataset looks up secondary properties by iWineId", "[joined_dataset]")
+{
+   TempFolder folder{};
+   writeListTable(folder.path, { { "1", "6" }, { "2", "12" } });
+   writeNotesTable(folder.path);
+
+   CtDatasetLoader loader{ folder.path };
+   auto joined = JoinedDataset::create(loader.getDataset(TableId::Notes), loader.getDataset(TableId::List));
+
+   REQUIRE(joined->rowCount() == 4);
+   CHECK(joined->getTableId() == TableId::Notes);
+   CHECK(joined->hasProperty(CtProp::TastingNotes));
+   CHECK(joined->hasProperty(CtProp::QtyOnHand));
+
+   SECTION("getProperty")
+   {
+      // every note for a wine gets that wine's quantity, and a wine that isn't in the List table gets null
+      auto quantities = quantitiesByWine(*joined);
+      CHECK(quantities[1] == NullableShort{ 6 });
+      CHECK(quantities[2] == NullableShort{ 12 });
+      CHECK(quantities[3] == std::nullopt);
+
+      // the primary's own properties aren't looked up in the secondary
+      std::set<std::string> notes{};
+      for (int row = 0; row < joined->rowCount(); ++row)
+      {
+         notes.insert(joined->getProperty(row, CtProp::TastingNotes).asString());
+      }
+      CHECK(notes == std::set<std::string>{ "", "Dark fruit, with a long finish", "Still too young" });
+   }
+
+   SECTION("getDistinctValues")
+   {
+      std::set<NullableShort> quantities{};
+      for (const auto& val : joined->getDistinctValues(CtProp::QtyOnHand, false))
+      {
+         quantities.insert(val.asUInt16());
+      }
+      CHECK(quantities == std::set<NullableShort>{ std::nullopt, 6, 12 });
+
+      // only the wines that pass the primary's filter are included
+      auto filtered = joined->getDistinctValues(CtProp::QtyOnHand, [](const CtPropertyMap& rec)
+         {
+            auto it = rec.find(CtProp::iWineId);
+            return it != rec.end() and it->second.asUInt64() == 2u;
+         });
+      REQUIRE(filtered.size() == 1);
+      CHECK(filtered.begin()->asUInt16() == 12);
+   }
+
+   SECTION("properties neither dataset has are null")
+   {
+      CHECK_FALSE(joined->hasProperty(CtProp::PendingPurchaseId));
+      CHECK(joined->getProperty(0, CtProp::PendingPurchaseId).isNull());
+      CHECK(joined->getDistinctValues(CtProp::PendingPurchaseId, false).empty());
+   }
+}
+
+
+TEST_CASE("WineLookupService finds a wine's records in each table", "[wine_lookup]")
+{
+   TempFolder folder{};
+   writeListTable(folder.path, { { "1", "6" }, { "2", "12" } });
+   writeNotesTable(folder.path);
+
+   WineLookupService service{ folder.path };
+
+   std::set<uint64_t> note_ids{};
+   auto count = service.findRecords(TableId::Notes, 1, [&note_ids](const CtPropertyMap& rec)
+      {
+         note_ids.insert(rec.find(CtProp::iTastingNoteId)->second.asUInt64().value_or(0));
+      });
+   CHECK(count == 2);
+   CHECK(note_ids == std::set<uint64_t>{ 101, 102 });
+
+   CHECK(service.findRecords(TableId::List, 4) == 0);
+   CHECK(service.findRecords(TableId::Consumed, 1) == 0);   // no table file
+
+   CHECK(service.countRecords(1) == std::map<TableId, size_t>{ { TableId::List, 1 }, { TableId::Notes, 2 } });
+   CHECK(service.countRecords(3) == std::map<TableId, size_t>{ { TableId::Notes, 1 } });
+}
+
+
+TEST_CASE("WineLookupService reloads a table when its file changes", "[wine_lookup]")
+{
+   TempFolder folder{};
+   writeListTable(folder.path, { { "1", "6" } });
+
+   auto quantity = [](WineLookupService& service, uint64_t wine_id)
+      {
+         NullableShort qty{};
+         service.findRecords(TableId::List, wine_id, [&qty](const CtPropertyMap& rec)
+            {
+               qty = rec.find(CtProp::QtyOnHand)->second.asUInt16();
+            });
+         return qty;
+      };
+
+   WineLookupService service{ folder.path };
+   REQUIRE(quantity(service, 1) == NullableShort{ 6 });
+
+   auto table_path = getTablePath(folder.path, TableId::List);
+   auto last_write = fs::last_write_time(table_path);
+
+   SECTION("a table with a new modification time is reloaded")
+   {
+      // same size as before, so only the modification time tells the versions apart
+      writeListTable(folder.path, { { "1", "3" } });
+      fs::last_write_time(table_path, last_write + std::chrono::hours{ 1 });
+
+      CHECK(quantity(service, 1) == NullableShort{ 3 });
+   }
+
+   SECTION("an unchanged table isn't reloaded")
+   {
+      // put the old modification time back, so it looks like the same version of the file
+      writeListTable(folder.path, { { "1", "3" } });
+      fs::last_write_time(table_path, last_write);
+
+      CHECK(quantity(service, 1) == NullableShort{ 6 });
+   }
+
+   SECTION("a table that's been removed has no records")
+   {
+      fs::remove(table_path);
+      CHECK(service.findRecords(TableId::List, 1) == 0);
+   }
+}